@@ -237,7 +237,15 @@ int main(int argc, char *argv[])
 
     std::unique_ptr<eows::core::http_server> server(eows::core::http_server_builder::instance().build(http_server_name));
 
-    return server->run();
+    const int status = server->run();
+
+#ifdef EOWS_GEOARRAY_ENABLED
+    eows::geoarray::finalize();
+#endif
+
+    eows::core::finalize();
+
+    return status;
   }
   catch(const std::exception& e)
   {
@@ -247,6 +255,12 @@ int main(int argc, char *argv[])
 
     EOWS_LOG_FATAL((err_msg % e.what()).str());
 
+#ifdef EOWS_GEOARRAY_ENABLED
+    eows::geoarray::finalize();
+#endif
+
+    eows::core::finalize();
+
     return EXIT_FAILURE;
   }
   catch(...)
@@ -255,6 +269,12 @@ int main(int argc, char *argv[])
     
     EOWS_LOG_FATAL("An unknown error occurred!");
 
+#ifdef EOWS_GEOARRAY_ENABLED
+    eows::geoarray::finalize();
+#endif
+
+    eows::core::finalize();
+
     return EXIT_FAILURE;
   }
 
@@ -0,0 +1,151 @@
+/*
+  Copyright (C) 2017 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of Earth Observation Web Services (EOWS).
+
+  EOWS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 3 as
+  published by the Free Software Foundation.
+
+  EOWS is distributed  "AS-IS" in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY OF ANY KIND; without even the implied warranty
+  of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with EOWS. See LICENSE. If not, write to
+  e-sensing team at <esensing-team@dpi.inpe.br>.
+ */
+
+
+/*!
+  \file eows/core/bounded_queue.hpp
+
+  \brief A blocking queue with a maximum size, linking the stages of a pipeline.
+ */
+
+#ifndef __EOWS_CORE_BOUNDED_QUEUE_HPP__
+#define __EOWS_CORE_BOUNDED_QUEUE_HPP__
+
+// STL
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+
+// Boost
+#include <boost/noncopyable.hpp>
+
+namespace eows
+{
+  namespace core
+  {
+
+    /*!
+      \class bounded_queue
+
+      \brief A FIFO queue shared by producer and consumer threads.
+
+      Producers block while the queue is full and consumers block while it is
+      empty, so a slow stage holds back the faster one instead of letting the
+      items pile up in memory. Closing the queue wakes up everyone: producers
+      give up and consumers take the remaining items and then stop.
+     */
+    template<class T>
+    class bounded_queue : public boost::noncopyable
+    {
+      public:
+
+        explicit bounded_queue(const std::size_t capacity);
+
+        /*!
+          \brief Adds an item, waiting for room if the queue is full.
+
+          \return False if the queue was closed and the item was discarded.
+         */
+        bool push(T&& item);
+
+        /*!
+          \brief Takes the oldest item, waiting for one if the queue is empty.
+
+          \return False if the queue is closed and has no more items.
+         */
+        bool pop(T& item);
+
+        //! Tells that no more items will be pushed or that the consumer gave up.
+        void close();
+
+      private:
+
+        std::mutex mtx_;
+        std::condition_variable not_full_;
+        std::condition_variable not_empty_;
+        std::deque<T> items_;
+        std::size_t capacity_;
+        bool closed_;
+    };
+
+    template<class T>
+    bounded_queue<T>::bounded_queue(const std::size_t capacity)
+      : capacity_(capacity == 0 ? 1 : capacity),
+        closed_(false)
+    {
+    }
+
+    template<class T>
+    bool bounded_queue<T>::push(T&& item)
+    {
+      std::unique_lock<std::mutex> lock(mtx_);
+
+      not_full_.wait(lock, [this]() { return closed_ || (items_.size() < capacity_); });
+
+      if(closed_)
+        return false;
+
+      items_.push_back(std::move(item));
+
+      lock.unlock();
+
+      not_empty_.notify_one();
+
+      return true;
+    }
+
+    template<class T>
+    bool bounded_queue<T>::pop(T& item)
+    {
+      std::unique_lock<std::mutex> lock(mtx_);
+
+      not_empty_.wait(lock, [this]() { return closed_ || !items_.empty(); });
+
+      if(items_.empty())
+        return false;
+
+      item = std::move(items_.front());
+
+      items_.pop_front();
+
+      lock.unlock();
+
+      not_full_.notify_one();
+
+      return true;
+    }
+
+    template<class T>
+    void bounded_queue<T>::close()
+    {
+      {
+        std::lock_guard<std::mutex> lock(mtx_);
+
+        closed_ = true;
+      }
+
+      not_full_.notify_all();
+      not_empty_.notify_all();
+    }
+
+  }  // end namespace core
+}    // end namespace eows
+
+#endif  // __EOWS_CORE_BOUNDED_QUEUE_HPP__
@@ -0,0 +1,362 @@
+/*
+  Copyright (C) 2017 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of Earth Observation Web Services (EOWS).
+
+  EOWS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 3 as
+  published by the Free Software Foundation.
+
+  EOWS is distributed  "AS-IS" in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY OF ANY KIND; without even the implied warranty
+  of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with EOWS. See LICENSE. If not, write to
+  e-sensing team at <esensing-team@dpi.inpe.br>.
+ */
+
+
+/*!
+  \file eows/core/compressed_response.cpp
+
+  \brief An HTTP response that compresses its body with the content coding accepted by the client.
+ */
+
+// EOWS
+#include "compressed_response.hpp"
+#include "metrics.hpp"
+
+// STL
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+
+// Boost
+#include <boost/algorithm/string/case_conv.hpp>
+#include <boost/algorithm/string/classification.hpp>
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/algorithm/string/split.hpp>
+#include <boost/algorithm/string/trim.hpp>
+
+// zlib
+#include <zlib.h>
+
+//! Size of the buffer receiving the compressed output
+static const std::size_t output_buffer_size = 64 * 1024;
+
+//! Largest piece given to zlib at once, whose sizes are 32-bit
+static const std::size_t max_input_size = 1 << 30;
+
+//! Returns the count of compressed bytes of a coding
+static eows::core::counter&
+encoder_bytes(const eows::core::compressed_response::coding_t coding)
+{
+  static eows::core::counter& gzip_bytes = eows::core::metrics_registry::instance().get_counter("eows_encoder_bytes_total", "Bytes written by the response encoders.", {{"encoder", "gzip"}});
+  static eows::core::counter& deflate_bytes = eows::core::metrics_registry::instance().get_counter("eows_encoder_bytes_total", "Bytes written by the response encoders.", {{"encoder", "deflate"}});
+
+  return (coding == eows::core::compressed_response::gzip) ? gzip_bytes : deflate_bytes;
+}
+
+struct eows::core::compressed_response::impl
+{
+  z_stream stream;
+  std::vector<char> output;
+};
+
+static eows::core::compression_settings_t make_default_settings()
+{
+  eows::core::compression_settings_t settings;
+
+  settings.types = { "application/json", "application/xml", "text/" };
+
+  return settings;
+}
+
+static eows::core::compression_settings_t current_settings = make_default_settings();
+
+eows::core::compressed_response::compressed_response(http_response& target, coding_t coding)
+  : target_(target),
+    coding_(coding),
+    pimpl_(nullptr),
+    started_(false),
+    streamed_(false),
+    finished_(false),
+    encoded_(false)
+{
+}
+
+eows::core::compressed_response::~compressed_response()
+{
+  if(pimpl_ != nullptr)
+  {
+    deflateEnd(&pimpl_->stream);
+
+    delete pimpl_;
+  }
+}
+
+void
+eows::core::compressed_response::set_status(status_t new_status)
+{
+  target_.set_status(new_status);
+}
+
+void
+eows::core::compressed_response::add_header(header_type_t field_name, const std::string& value)
+{
+  add_header(std::string(to_str(field_name)), value);
+}
+
+void
+eows::core::compressed_response::add_header(const std::string& field_name, const std::string& value)
+{
+// the body length is known only after deciding whether it is compressed
+  if(boost::iequals(field_name, to_str(CONTENT_LENGTH)))
+  {
+    body_length_ = value;
+    return;
+  }
+
+// a compressed body is another representation: its tag is made weak
+  if(boost::iequals(field_name, "ETag"))
+  {
+    entity_tag_ = value;
+    return;
+  }
+
+  if(boost::iequals(field_name, to_str(CONTENT_TYPE)))
+    media_type_ = value;
+  else if(boost::iequals(field_name, "Content-Encoding"))
+    encoded_ = true;
+
+  target_.add_header(field_name, value);
+}
+
+void
+eows::core::compressed_response::write(const char* value, const std::size_t size)
+{
+  if(!started_)
+    start(size, false);
+
+  if(coding_ == identity)
+    target_.write(value, size);
+  else
+    compress(value, size, Z_NO_FLUSH);
+}
+
+void
+eows::core::compressed_response::write(std::string&& value)
+{
+  if(!started_)
+    start(value.size(), false);
+
+  if(coding_ == identity)
+    target_.write(std::move(value));
+  else
+    compress(value.data(), value.size(), Z_NO_FLUSH);
+}
+
+void
+eows::core::compressed_response::begin_stream()
+{
+  if(!started_)
+    start(0, true);
+
+  target_.begin_stream();
+}
+
+void
+eows::core::compressed_response::write_chunk(const char* value, const std::size_t size)
+{
+  if(!started_)
+    start(size, true);
+
+  if(coding_ == identity)
+    target_.write_chunk(value, size);
+  else
+    compress(value, size, Z_NO_FLUSH);
+}
+
+void
+eows::core::compressed_response::end()
+{
+  finish();
+
+  target_.end();
+}
+
+void
+eows::core::compressed_response::finish()
+{
+  if(finished_)
+    return;
+
+  finished_ = true;
+
+  if(pimpl_ != nullptr)
+    compress(nullptr, 0, Z_FINISH);
+}
+
+eows::core::compressed_response::coding_t
+eows::core::compressed_response::negotiate(const std::string& accept_encoding)
+{
+  if(!current_settings.enabled || accept_encoding.empty())
+    return identity;
+
+  double gzip_q = -1.0;
+  double deflate_q = -1.0;
+  double any_q = -1.0;
+
+  std::vector<std::string> codings;
+
+  boost::split(codings, accept_encoding, boost::is_any_of(","));
+
+// each coding may have a quality value: gzip;q=0.8
+  for(const std::string& coding: codings)
+  {
+    std::vector<std::string> params;
+
+    boost::split(params, coding, boost::is_any_of(";"));
+
+    const std::string name = boost::to_lower_copy(boost::trim_copy(params[0]));
+
+    double q = 1.0;
+
+    for(std::size_t i = 1; i < params.size(); ++i)
+    {
+      const std::string param = boost::trim_copy(params[i]);
+
+      if(boost::istarts_with(param, "q="))
+        q = std::strtod(param.c_str() + 2, nullptr);
+    }
+
+    if(name == "gzip" || name == "x-gzip")
+      gzip_q = q;
+    else if(name == "deflate")
+      deflate_q = q;
+    else if(name == "*")
+      any_q = q;
+  }
+
+  if(gzip_q < 0.0)
+    gzip_q = any_q;
+
+  if(deflate_q < 0.0)
+    deflate_q = any_q;
+
+  if(gzip_q > 0.0 && gzip_q >= deflate_q)
+    return gzip;
+
+  if(deflate_q > 0.0)
+    return deflate;
+
+  return identity;
+}
+
+void
+eows::core::compressed_response::configure(const compression_settings_t& settings)
+{
+  current_settings = settings;
+}
+
+const eows::core::compression_settings_t&
+eows::core::compressed_response::settings()
+{
+  return current_settings;
+}
+
+void
+eows::core::compressed_response::start(const std::size_t size, const bool streamed)
+{
+  started_ = true;
+  streamed_ = streamed;
+
+  const bool compressible = std::any_of(current_settings.types.begin(), current_settings.types.end(),
+                                        [this](const std::string& type)
+                                        {
+                                          return boost::istarts_with(media_type_, type);
+                                        });
+
+  if(encoded_ || !compressible || (!streamed && size < current_settings.min_size))
+    coding_ = identity;
+
+  if(coding_ == identity)
+  {
+    if(!body_length_.empty())
+      target_.add_header(CONTENT_LENGTH, body_length_);
+
+    if(!entity_tag_.empty())
+      target_.add_header("ETag", entity_tag_);
+
+    return;
+  }
+
+  pimpl_ = new impl;
+  pimpl_->stream.zalloc = Z_NULL;
+  pimpl_->stream.zfree = Z_NULL;
+  pimpl_->stream.opaque = Z_NULL;
+  pimpl_->output.resize(output_buffer_size);
+
+// window bits above 15 ask zlib for a gzip wrapper instead of a zlib one
+  const int window_bits = (coding_ == gzip) ? 15 + 16 : 15;
+
+  if(deflateInit2(&pimpl_->stream, current_settings.level, Z_DEFLATED, window_bits, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+  {
+    delete pimpl_;
+    pimpl_ = nullptr;
+
+    throw std::runtime_error("Could not initialize response compression.");
+  }
+
+  target_.add_header("Content-Encoding", (coding_ == gzip) ? "gzip" : "deflate");
+  target_.add_header("Vary", "Accept-Encoding");
+
+  if(!entity_tag_.empty())
+    target_.add_header("ETag", boost::starts_with(entity_tag_, "W/") ? entity_tag_ : "W/" + entity_tag_);
+}
+
+void
+eows::core::compressed_response::compress(const char* value, const std::size_t size, const int flush)
+{
+  z_stream& stream = pimpl_->stream;
+
+  std::size_t offset = 0;
+
+  do
+  {
+    const std::size_t piece = std::min(size - offset, max_input_size);
+
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(value + offset));
+    stream.avail_in = static_cast<uInt>(piece);
+
+    offset += piece;
+
+// the last piece carries the flush mode
+    const int mode = (offset == size) ? flush : Z_NO_FLUSH;
+
+    do
+    {
+      stream.next_out = reinterpret_cast<Bytef*>(pimpl_->output.data());
+      stream.avail_out = static_cast<uInt>(pimpl_->output.size());
+
+      if(::deflate(&stream, mode) == Z_STREAM_ERROR)
+        throw std::runtime_error("Could not compress response.");
+
+      const std::size_t nbytes = pimpl_->output.size() - stream.avail_out;
+
+      if(nbytes != 0)
+      {
+        encoder_bytes(coding_).inc(nbytes);
+
+        if(streamed_)
+          target_.write_chunk(pimpl_->output.data(), nbytes);
+        else
+          target_.write(pimpl_->output.data(), nbytes);
+      }
+    }
+    while(stream.avail_out == 0);
+  }
+  while(offset < size);
+}
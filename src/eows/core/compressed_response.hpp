@@ -0,0 +1,139 @@
+/*
+  Copyright (C) 2017 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of Earth Observation Web Services (EOWS).
+
+  EOWS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 3 as
+  published by the Free Software Foundation.
+
+  EOWS is distributed  "AS-IS" in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY OF ANY KIND; without even the implied warranty
+  of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with EOWS. See LICENSE. If not, write to
+  e-sensing team at <esensing-team@dpi.inpe.br>.
+ */
+
+
+/*!
+  \file eows/core/compressed_response.hpp
+
+  \brief An HTTP response that compresses its body with the content coding accepted by the client.
+ */
+
+#ifndef __EOWS_CORE_COMPRESSED_RESPONSE_HPP__
+#define __EOWS_CORE_COMPRESSED_RESPONSE_HPP__
+
+// EOWS
+#include "http_response.hpp"
+
+// STL
+#include <string>
+#include <vector>
+
+namespace eows
+{
+  namespace core
+  {
+
+    //! Response compression settings, read from the 'http_compression' key of the configuration file.
+    struct compression_settings_t
+    {
+      bool enabled = true;             //!< Compression is done only when enabled
+      std::size_t min_size = 1024;     //!< Smaller bodies are sent as is. Streamed bodies are always compressed
+      int level = 6;                   //!< zlib level, from 1 (fastest) to 9 (smallest)
+      std::vector<std::string> types;  //!< Compressed media types, matched as prefixes of Content-Type
+    };
+
+    /*!
+      \class compressed_response
+
+      \brief Wraps a response, compressing its body with gzip or deflate when the client accepts it.
+
+      The body is compressed as it is written, on the thread running the handler,
+      and handed over to the wrapped response piece by piece. Whether to compress
+      is decided at the first write: the Content-Type must be one of the configured
+      types, the handler must not have set a Content-Encoding, and the body must
+      not be smaller than the configured minimum size.
+
+      finish must be called once the handler is done.
+     */
+    class compressed_response : public http_response
+    {
+      public:
+
+        //! The content codings that may be negotiated.
+        enum coding_t
+        {
+          identity,
+          gzip,
+          deflate
+        };
+
+        compressed_response(http_response& target, coding_t coding);
+
+        ~compressed_response();
+
+        void set_status(status_t new_status) override;
+
+        void add_header(header_type_t field_name, const std::string& value) override;
+
+        void add_header(const std::string& field_name, const std::string& value) override;
+
+        void write(const char* value, const std::size_t size) override;
+
+        void write(std::string&& value) override;
+
+        void begin_stream() override;
+
+        void write_chunk(const char* value, const std::size_t size) override;
+
+        void end() override;
+
+        //! Flushes the compressed data that is left.
+        void finish();
+
+        /*!
+          \brief Picks the content coding of a response from the value of an Accept-Encoding header.
+
+          \return identity when compression is disabled or the client accepts neither gzip nor deflate.
+         */
+        static coding_t negotiate(const std::string& accept_encoding);
+
+        //! Set the compression settings. It must be called before serving requests.
+        static void configure(const compression_settings_t& settings);
+
+        //! The current compression settings.
+        static const compression_settings_t& settings();
+
+      private:
+
+        //! Decides whether the body is compressed, given the size of its first piece.
+        void start(const std::size_t size, const bool streamed);
+
+        //! Compresses a piece of the body, handing the output over to the wrapped response.
+        void compress(const char* value, const std::size_t size, const int flush);
+
+      private:
+
+        struct impl;
+
+        http_response& target_;
+        coding_t coding_;
+        impl* pimpl_;               //!< zlib stream, when the body is compressed
+        bool started_;
+        bool streamed_;
+        bool finished_;
+        bool encoded_;              //!< The handler set its own Content-Encoding
+        std::string media_type_;    //!< Content-Type set by the handler
+        std::string body_length_;   //!< Content-Length, sent only if the body is not compressed
+        std::string entity_tag_;    //!< ETag, made weak if the body is compressed
+    };
+
+  }  // end namespace core
+}    // end namespace eows
+
+#endif  // __EOWS_CORE_COMPRESSED_RESPONSE_HPP__
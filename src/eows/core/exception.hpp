@@ -31,12 +31,25 @@
 // EOWS
 #include "../exception.hpp"
 
+// STL
+#include <cstddef>
+
 namespace eows
 {
   //! The namespace for the Core Runtime module of EOWS.
   namespace core
   {
 
+    //! An exception indicating that a service has no room for more requests for now.
+    struct service_unavailable_error : public eows::eows_error
+    {
+      service_unavailable_error(const std::string& s, const std::size_t retry)
+        : eows_error(s), retry_after(retry)
+      {
+      }
+
+      std::size_t retry_after; //!< Seconds the client should wait before retrying
+    };
 
   }  // end namespace core
 }    // end namespace eows
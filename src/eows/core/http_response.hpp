@@ -131,10 +131,50 @@ namespace eows
         /*!
           \brief Write data to the response.
 
+          Data is binary safe: it may contain NUL bytes.
+
           \note The implementation must not cache the pointer.
          */
         virtual void write(const char* value, const std::size_t size) = 0;
-      
+
+        /*!
+          \brief Write data to the response, handing over its buffer.
+
+          The default implementation writes the buffer content. Backends that keep
+          the body until the request is done may take the buffer instead of copying it.
+         */
+        virtual void write(std::string&& value)
+        {
+          write(value.data(), value.size());
+        }
+
+        /*!
+          \brief Starts a streamed response, whose body is sent in pieces with write_chunk.
+
+          Status and headers must be set before. The default implementation
+          does nothing: the pieces are written with write and sent as a single body.
+
+          \pre Data have not been write.
+         */
+        virtual void begin_stream()
+        {
+        }
+
+        /*!
+          \brief Sends a piece of a streamed response.
+
+          \note The implementation must not cache the pointer.
+         */
+        virtual void write_chunk(const char* value, const std::size_t size)
+        {
+          write(value, size);
+        }
+
+        //! Finishes a streamed response.
+        virtual void end()
+        {
+        }
+
       protected:
     
         static const char access_control_allow_origin_[];
@@ -0,0 +1,427 @@
+/*
+  Copyright (C) 2017 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of Earth Observation Web Services (EOWS).
+
+  EOWS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 3 as
+  published by the Free Software Foundation.
+
+  EOWS is distributed  "AS-IS" in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY OF ANY KIND; without even the implied warranty
+  of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with EOWS. See LICENSE. If not, write to
+  e-sensing team at <esensing-team@dpi.inpe.br>.
+ */
+
+/*!
+  \file eows/core/log_sink.cpp
+
+  \brief The log file sink, written by a background thread.
+ */
+
+// EOWS
+#include "log_sink.hpp"
+#include "logger.hpp"
+#include "metrics.hpp"
+
+// STL
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// Boost
+#include <boost/format.hpp>
+#include <boost/log/attributes/value_extraction.hpp>
+#include <boost/log/expressions.hpp>
+#include <boost/log/sinks/async_frontend.hpp>
+#include <boost/log/sinks/sync_frontend.hpp>
+#include <boost/log/sinks/text_file_backend.hpp>
+#include <boost/log/utility/setup/formatter_parser.hpp>
+#include <boost/make_shared.hpp>
+
+BOOST_LOG_ATTRIBUTE_KEYWORD(channel, "Channel", std::string)
+
+namespace
+{
+  //! Settings of the next queue to be built: Boost.Log builds it inside the sink
+  eows::core::log_settings_t queue_settings;
+
+  /*!
+    \brief A Boost.Log queueing strategy over a bounded lock-free ring buffer.
+
+    Every slot has a sequence number telling whether it is ready to be
+    written or read, so producers and the consumer only race on the
+    positions, with a compare-and-swap. The consumer only sleeps, on a
+    condition variable, when the buffer is empty.
+   */
+  class log_queue
+  {
+    public:
+
+      //! Records discarded because the buffer was full.
+      uint64_t dropped() const
+      {
+        return dropped_.value();
+      }
+
+    protected:
+
+      log_queue()
+        : overflow_(queue_settings.overflow),
+          waiting_(false),
+          interrupted_(false),
+          dropped_(eows::core::metrics_registry::instance().get_counter("eows_log_records_dropped_total",
+                                                                        "Log records discarded because the log queue was full."))
+      {
+        std::size_t capacity = 2;
+
+        while(capacity < queue_settings.queue_size)
+          capacity <<= 1;
+
+        cells_.reset(new cell_t[capacity]);
+        mask_ = capacity - 1;
+
+        for(std::size_t i = 0; i != capacity; ++i)
+          cells_[i].sequence.store(i, std::memory_order_relaxed);
+
+        enqueue_pos_.store(0, std::memory_order_relaxed);
+        dequeue_pos_.store(0, std::memory_order_relaxed);
+      }
+
+      template<class ArgsT>
+      explicit log_queue(const ArgsT&)
+        : log_queue()
+      {
+      }
+
+      void enqueue(const boost::log::record_view& rec)
+      {
+        if(push(rec))
+          return;
+
+        if((overflow_ == eows::core::log_settings_t::drop) ||
+           ((overflow_ == eows::core::log_settings_t::drop_below_warning) && (severity(rec) < boost::log::trivial::warning)))
+        {
+          dropped_.inc();
+          return;
+        }
+
+// the consumer is awake, as the buffer is full: wait for it to make room
+        while(!push(rec))
+          std::this_thread::sleep_for(std::chrono::microseconds(100));
+      }
+
+      bool try_enqueue(const boost::log::record_view& rec)
+      {
+        return push(rec);
+      }
+
+      bool try_dequeue_ready(boost::log::record_view& rec)
+      {
+        return pop(rec);
+      }
+
+      bool try_dequeue(boost::log::record_view& rec)
+      {
+        return pop(rec);
+      }
+
+      bool dequeue_ready(boost::log::record_view& rec)
+      {
+        while(true)
+        {
+          if(pop(rec))
+            return true;
+
+          std::unique_lock<std::mutex> lock(mtx_);
+
+          if(interrupted_)
+          {
+            interrupted_ = false;
+            return false;
+          }
+
+          waiting_.store(true, std::memory_order_relaxed);
+
+// pairs with the fence of wake: either a producer sees waiting_ or this pop sees its record
+          std::atomic_thread_fence(std::memory_order_seq_cst);
+
+          if(pop(rec))
+          {
+            waiting_.store(false, std::memory_order_relaxed);
+            return true;
+          }
+
+          ready_.wait(lock);
+
+          waiting_.store(false, std::memory_order_relaxed);
+        }
+      }
+
+      void interrupt_dequeue()
+      {
+        std::lock_guard<std::mutex> lock(mtx_);
+
+        interrupted_ = true;
+
+        ready_.notify_one();
+      }
+
+    private:
+
+      struct cell_t
+      {
+        std::atomic<std::size_t> sequence;
+        boost::log::record_view record;
+      };
+
+      static boost::log::trivial::severity_level severity(const boost::log::record_view& rec)
+      {
+        return boost::log::extract_or_default<boost::log::trivial::severity_level>("Severity", rec, boost::log::trivial::info);
+      }
+
+      bool push(const boost::log::record_view& rec)
+      {
+        std::size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+
+        cell_t* cell;
+
+        while(true)
+        {
+          cell = &cells_[pos & mask_];
+
+          const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+          const std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+
+// the slot is free: claim it
+          if(diff == 0)
+          {
+            if(enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+              break;
+          }
+// the slot still holds a record not read: the buffer is full
+          else if(diff < 0)
+          {
+            return false;
+          }
+// another producer claimed it
+          else
+          {
+            pos = enqueue_pos_.load(std::memory_order_relaxed);
+          }
+        }
+
+        cell->record = rec;
+        cell->sequence.store(pos + 1, std::memory_order_release);
+
+        wake();
+
+        return true;
+      }
+
+      bool pop(boost::log::record_view& rec)
+      {
+        std::size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+
+        cell_t* cell;
+
+        while(true)
+        {
+          cell = &cells_[pos & mask_];
+
+          const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+          const std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos + 1);
+
+          if(diff == 0)
+          {
+            if(dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+              break;
+          }
+          else if(diff < 0)
+          {
+            return false;
+          }
+          else
+          {
+            pos = dequeue_pos_.load(std::memory_order_relaxed);
+          }
+        }
+
+// leave the slot empty, releasing the record, and hand it over to the producers
+        rec.swap(cell->record);
+        cell->record = boost::log::record_view();
+        cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+
+        return true;
+      }
+
+//! Wakes the consumer up if it is sleeping
+      void wake()
+      {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if(!waiting_.load(std::memory_order_relaxed))
+          return;
+
+        std::lock_guard<std::mutex> lock(mtx_);
+
+        ready_.notify_one();
+      }
+
+    private:
+
+      std::unique_ptr<cell_t[]> cells_;
+      std::size_t mask_;
+      char pad0_[64];
+      std::atomic<std::size_t> enqueue_pos_;   //!< Apart from dequeue_pos_, as producers and the consumer update them
+      char pad1_[64];
+      std::atomic<std::size_t> dequeue_pos_;
+      char pad2_[64];
+      eows::core::log_settings_t::overflow_t overflow_;
+      std::atomic<bool> waiting_;              //!< The consumer is sleeping on ready_
+      std::mutex mtx_;
+      std::condition_variable ready_;
+      bool interrupted_;
+      eows::core::counter& dropped_;
+  };
+
+  typedef boost::log::sinks::text_file_backend file_backend_t;
+  typedef boost::log::sinks::asynchronous_sink<file_backend_t, log_queue> async_sink_t;
+  typedef boost::log::sinks::synchronous_sink<file_backend_t> sync_sink_t;
+
+  //! The sink in use and the thread flushing it
+  struct log_state_t
+  {
+    boost::shared_ptr<async_sink_t> async_sink;
+    boost::shared_ptr<sync_sink_t> sync_sink;
+    std::thread flusher;
+    std::mutex mtx;
+    std::condition_variable stop_requested;
+    bool stop = false;
+
+    //! Stops the flusher, in case the program exits without calling stop_file_log.
+    ~log_state_t()
+    {
+      stop_flusher();
+    }
+
+    void stop_flusher()
+    {
+      if(!flusher.joinable())
+        return;
+
+      {
+        std::lock_guard<std::mutex> lock(mtx);
+
+        stop = true;
+      }
+
+      stop_requested.notify_all();
+
+      flusher.join();
+    }
+  };
+
+  log_state_t log_state;
+
+  //! Flushes the file every interval, reporting the records dropped meanwhile
+  void run_flusher(const std::chrono::milliseconds interval)
+  {
+    uint64_t reported = 0;
+
+    std::unique_lock<std::mutex> lock(log_state.mtx);
+
+    while(!log_state.stop_requested.wait_for(lock, interval, []() -> bool { return log_state.stop; }))
+    {
+      lock.unlock();
+
+      log_state.async_sink->flush();
+
+      const uint64_t dropped = log_state.async_sink->dropped();
+
+      if(dropped != reported)
+      {
+        boost::format msg("%1% log record(s) were dropped: the log queue was full.");
+
+        EOWS_LOG_WARN((msg % (dropped - reported)).str());
+
+        reported = dropped;
+      }
+
+      lock.lock();
+    }
+  }
+}
+
+void
+eows::core::start_file_log(const log_settings_t& settings)
+{
+  boost::shared_ptr<file_backend_t> backend =
+      boost::make_shared<file_backend_t>(boost::log::keywords::file_name = settings.file_name,
+                                         boost::log::keywords::rotation_size = 10 * 1024 * 1024,
+                                         boost::log::keywords::auto_flush = !settings.async);
+
+  const std::string channel_name = "eows";
+
+  if(!settings.async)
+  {
+    log_state.sync_sink = boost::make_shared<sync_sink_t>(backend);
+
+    log_state.sync_sink->set_formatter(boost::log::parse_formatter(settings.format));
+    log_state.sync_sink->set_filter((channel == channel_name) && (boost::log::trivial::severity >= settings.level));
+
+    boost::log::core::get()->add_sink(log_state.sync_sink);
+
+    return;
+  }
+
+// the sink builds its queue, which reads these settings, and starts the writing thread
+  queue_settings = settings;
+
+  log_state.async_sink = boost::make_shared<async_sink_t>(backend);
+
+  log_state.async_sink->set_formatter(boost::log::parse_formatter(settings.format));
+  log_state.async_sink->set_filter((channel == channel_name) && (boost::log::trivial::severity >= settings.level));
+
+  boost::log::core::get()->add_sink(log_state.async_sink);
+
+// the file is written in batches: flush it now and then
+  if(settings.flush_interval != 0)
+  {
+    log_state.stop = false;
+    log_state.flusher = std::thread(&run_flusher, std::chrono::milliseconds(settings.flush_interval));
+  }
+}
+
+void
+eows::core::stop_file_log()
+{
+  log_state.stop_flusher();
+
+  if(log_state.async_sink != nullptr)
+  {
+    boost::log::core::get()->remove_sink(log_state.async_sink);
+
+// stop the writing thread, then write what is left and flush the file
+    log_state.async_sink->stop();
+    log_state.async_sink->flush();
+
+    log_state.async_sink.reset();
+  }
+
+  if(log_state.sync_sink != nullptr)
+  {
+    boost::log::core::get()->remove_sink(log_state.sync_sink);
+
+    log_state.sync_sink->flush();
+
+    log_state.sync_sink.reset();
+  }
+}
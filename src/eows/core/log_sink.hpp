@@ -0,0 +1,76 @@
+/*
+  Copyright (C) 2017 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of Earth Observation Web Services (EOWS).
+
+  EOWS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 3 as
+  published by the Free Software Foundation.
+
+  EOWS is distributed  "AS-IS" in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY OF ANY KIND; without even the implied warranty
+  of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with EOWS. See LICENSE. If not, write to
+  e-sensing team at <esensing-team@dpi.inpe.br>.
+ */
+
+/*!
+  \file eows/core/log_sink.hpp
+
+  \brief The log file sink, written by a background thread.
+ */
+
+#ifndef __EOWS_CORE_LOG_SINK_HPP__
+#define __EOWS_CORE_LOG_SINK_HPP__
+
+// STL
+#include <cstddef>
+#include <string>
+
+// Boost
+#include <boost/log/trivial.hpp>
+
+namespace eows
+{
+  namespace core
+  {
+
+    //! How the log file is written.
+    struct log_settings_t
+    {
+      //! What happens to a record when the queue is full.
+      enum overflow_t
+      {
+        drop,                //!< The record is discarded
+        block,               //!< The logging thread waits for room
+        drop_below_warning   //!< Warnings and errors wait for room, the other records are discarded
+      };
+
+      std::string file_name;
+      std::string format;
+      boost::log::trivial::severity_level level = boost::log::trivial::trace;  //!< Records below it are filtered out
+      bool async = true;                 //!< If false, records are written and flushed by the logging thread
+      std::size_t queue_size = 8192;     //!< Records waiting to be written, rounded up to a power of two
+      overflow_t overflow = drop;
+      std::size_t flush_interval = 1000; //!< Time between flushes of the file, in milliseconds
+    };
+
+    /*!
+      \brief Adds the file sink of the 'eows' channel.
+
+      In asynchronous mode, the logging thread only puts the record in a
+      lock-free ring buffer. A background thread formats the records and
+      writes them to the file, which is flushed every flush_interval.
+     */
+    void start_file_log(const log_settings_t& settings);
+
+    //! Writes the pending records, flushes the file and removes the sink.
+    void stop_file_log();
+
+  }  // end namespace core
+}    // end namespace eows
+
+#endif  // __EOWS_CORE_LOG_SINK_HPP__
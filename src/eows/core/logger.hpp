@@ -43,34 +43,33 @@ namespace eows
 
 #define EOWS_CURRENT_FUNCTION std::string(__PRETTY_FUNCTION__)
 
-#define EOWS_LOG_TRACE(message) \
-        BOOST_LOG_CHANNEL_SEV(eows::core::m_logger, \
-                              "eows", \
-                              boost::log::trivial::trace) << message
-
-#define EOWS_LOG_DEBUG(message) \
-        BOOST_LOG_CHANNEL_SEV(eows::core::m_logger, \
-                              "eows", \
-                              boost::log::trivial::debug) << message
-
-#define EOWS_LOG_INFO(message) \
-        BOOST_LOG_CHANNEL_SEV(eows::core::m_logger, \
-                              "eows", \
-                              boost::log::trivial::info) << message
-
-#define EOWS_LOG_WARN(message) \
-        BOOST_LOG_CHANNEL_SEV(eows::core::m_logger, \
-                              "eows", \
-                              boost::log::trivial::warning) << message
-
-#define EOWS_LOG_ERROR(message) \
-        BOOST_LOG_CHANNEL_SEV(eows::core::m_logger, \
-                              "eows", \
-                              boost::log::trivial::error) << message
-
-#define EOWS_LOG_FATAL(message) \
-        BOOST_LOG_CHANNEL_SEV(eows::core::m_logger, \
-                              "eows", \
-                              boost::log::trivial::fatal) << message
+/*!
+  \def EOWS_LOG_MIN_LEVEL
+
+  \brief The lowest level compiled in: 0 trace, 1 debug, 2 info, 3 warning, 4 error and 5 fatal.
+
+  Below it, the EOWS_LOG_* statements are dead code: the message is not even built.
+ */
+#ifndef EOWS_LOG_MIN_LEVEL
+#define EOWS_LOG_MIN_LEVEL 0
+#endif
+
+#define EOWS_LOG_SEV(level, severity, message) \
+        for(bool eows_log_enabled_ = ((level) >= EOWS_LOG_MIN_LEVEL); eows_log_enabled_; eows_log_enabled_ = false) \
+          BOOST_LOG_CHANNEL_SEV(eows::core::m_logger, \
+                                "eows", \
+                                severity) << message
+
+#define EOWS_LOG_TRACE(message) EOWS_LOG_SEV(0, boost::log::trivial::trace, message)
+
+#define EOWS_LOG_DEBUG(message) EOWS_LOG_SEV(1, boost::log::trivial::debug, message)
+
+#define EOWS_LOG_INFO(message) EOWS_LOG_SEV(2, boost::log::trivial::info, message)
+
+#define EOWS_LOG_WARN(message) EOWS_LOG_SEV(3, boost::log::trivial::warning, message)
+
+#define EOWS_LOG_ERROR(message) EOWS_LOG_SEV(4, boost::log::trivial::error, message)
+
+#define EOWS_LOG_FATAL(message) EOWS_LOG_SEV(5, boost::log::trivial::fatal, message)
 
 #endif // __EOWS_CORE_LOGGER_HPP__
@@ -0,0 +1,356 @@
+/*
+  Copyright (C) 2017 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of Earth Observation Web Services (EOWS).
+
+  EOWS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 3 as
+  published by the Free Software Foundation.
+
+  EOWS is distributed  "AS-IS" in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY OF ANY KIND; without even the implied warranty
+  of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with EOWS. See LICENSE. If not, write to
+  e-sensing team at <esensing-team@dpi.inpe.br>.
+ */
+
+/*!
+  \file eows/core/metrics.cpp
+
+  \brief Counters, gauges and histograms exposed in the Prometheus text format.
+ */
+
+// EOWS
+#include "metrics.hpp"
+#include "http_response.hpp"
+
+// STL
+#include <algorithm>
+#include <limits>
+#include <locale>
+#include <sstream>
+#include <stdexcept>
+
+// Boost
+#include <boost/format.hpp>
+
+std::size_t
+eows::core::metric_shard()
+{
+  static std::atomic<std::size_t> next_shard(0);
+
+// threads are spread over the shards in the order they first update a metric
+  thread_local const std::size_t shard = next_shard.fetch_add(1, std::memory_order_relaxed) % metric_shards;
+
+  return shard;
+}
+
+eows::core::counter::counter()
+  : shards_(new shard_t[metric_shards])
+{
+  for(std::size_t i = 0; i != metric_shards; ++i)
+    shards_[i].value.store(0, std::memory_order_relaxed);
+}
+
+uint64_t
+eows::core::counter::value() const
+{
+  uint64_t total = 0;
+
+  for(std::size_t i = 0; i != metric_shards; ++i)
+    total += shards_[i].value.load(std::memory_order_relaxed);
+
+  return total;
+}
+
+eows::core::gauge::gauge()
+  : shards_(new shard_t[metric_shards])
+{
+  for(std::size_t i = 0; i != metric_shards; ++i)
+    shards_[i].value.store(0, std::memory_order_relaxed);
+}
+
+int64_t
+eows::core::gauge::value() const
+{
+  int64_t total = 0;
+
+  for(std::size_t i = 0; i != metric_shards; ++i)
+    total += shards_[i].value.load(std::memory_order_relaxed);
+
+  return total;
+}
+
+eows::core::histogram::shard_t::shard_t(const std::size_t nbuckets)
+  : counts(new std::atomic<uint64_t>[nbuckets]),
+    sum(0.0)
+{
+  for(std::size_t i = 0; i != nbuckets; ++i)
+    counts[i].store(0, std::memory_order_relaxed);
+}
+
+eows::core::histogram::histogram(const std::vector<double>& bounds)
+  : bounds_(bounds)
+{
+  if(!std::is_sorted(bounds_.begin(), bounds_.end()))
+    throw std::invalid_argument("Histogram bucket bounds must be in increasing order.");
+
+  for(std::size_t i = 0; i != metric_shards; ++i)
+    shards_.emplace_back(new shard_t(bounds_.size() + 1));
+}
+
+void
+eows::core::histogram::observe(const double value)
+{
+  shard_t& shard = *shards_[metric_shard()];
+
+// the first bucket whose bound is not less than the value, or the +Inf one
+  const std::size_t bucket = static_cast<std::size_t>(std::lower_bound(bounds_.begin(), bounds_.end(), value) - bounds_.begin());
+
+  shard.counts[bucket].fetch_add(1, std::memory_order_relaxed);
+
+// there is no fetch_add for doubles: other threads rarely touch the same shard
+  double sum = shard.sum.load(std::memory_order_relaxed);
+
+  while(!shard.sum.compare_exchange_weak(sum, sum + value, std::memory_order_relaxed))
+    ;
+}
+
+eows::core::histogram::snapshot_t
+eows::core::histogram::snapshot() const
+{
+  snapshot_t result;
+
+  result.counts.assign(bounds_.size() + 1, 0);
+  result.sum = 0.0;
+
+  for(const std::unique_ptr<shard_t>& shard : shards_)
+  {
+    for(std::size_t i = 0; i != result.counts.size(); ++i)
+      result.counts[i] += shard->counts[i].load(std::memory_order_relaxed);
+
+    result.sum += shard->sum.load(std::memory_order_relaxed);
+  }
+
+  return result;
+}
+
+const std::vector<double>&
+eows::core::latency_buckets()
+{
+  static const std::vector<double> buckets = { 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1,
+                                               0.25, 0.5, 1.0, 2.5, 5.0, 10.0, 30.0, 60.0 };
+
+  return buckets;
+}
+
+//! Formats the labels as name="value" pairs separated by commas, escaping the values.
+static std::string
+format_labels(const eows::core::metric_labels_t& labels)
+{
+  std::string result;
+
+  for(const auto& label : labels)
+  {
+    if(!result.empty())
+      result += ',';
+
+    result += label.first;
+    result += "=\"";
+
+    for(const char c : label.second)
+    {
+      if(c == '\\')
+        result += "\\\\";
+      else if(c == '"')
+        result += "\\\"";
+      else if(c == '\n')
+        result += "\\n";
+      else
+        result += c;
+    }
+
+    result += '"';
+  }
+
+  return result;
+}
+
+//! Writes a sample line: name{labels} value.
+template<class T> static void
+write_sample(std::ostringstream& out, const std::string& name, const std::string& labels, const T& value)
+{
+  out << name;
+
+  if(!labels.empty())
+    out << '{' << labels << '}';
+
+  out << ' ' << value << '\n';
+}
+
+eows::core::metrics_registry::family_t&
+eows::core::metrics_registry::family(const std::string& name, const std::string& help, const kind_t kind)
+{
+  std::map<std::string, family_t>::iterator it = families_.find(name);
+
+  if(it == families_.end())
+  {
+    family_t& f = families_[name];
+
+    f.kind = kind;
+    f.help = help;
+
+    return f;
+  }
+
+  if(it->second.kind != kind)
+  {
+    boost::format err_msg("Metric '%1%' is already registered with another type.");
+
+    throw std::invalid_argument((err_msg % name).str());
+  }
+
+  return it->second;
+}
+
+eows::core::counter&
+eows::core::metrics_registry::get_counter(const std::string& name, const std::string& help,
+                                          const metric_labels_t& labels)
+{
+  std::lock_guard<std::mutex> lock(mtx_);
+
+  std::unique_ptr<counter>& c = family(name, help, counter_kind).counters[format_labels(labels)];
+
+  if(c == nullptr)
+    c.reset(new counter);
+
+  return *c;
+}
+
+eows::core::gauge&
+eows::core::metrics_registry::get_gauge(const std::string& name, const std::string& help,
+                                        const metric_labels_t& labels)
+{
+  std::lock_guard<std::mutex> lock(mtx_);
+
+  std::unique_ptr<gauge>& g = family(name, help, gauge_kind).gauges[format_labels(labels)];
+
+  if(g == nullptr)
+    g.reset(new gauge);
+
+  return *g;
+}
+
+eows::core::histogram&
+eows::core::metrics_registry::get_histogram(const std::string& name, const std::string& help,
+                                            const metric_labels_t& labels,
+                                            const std::vector<double>& bounds)
+{
+  std::lock_guard<std::mutex> lock(mtx_);
+
+  std::unique_ptr<histogram>& h = family(name, help, histogram_kind).histograms[format_labels(labels)];
+
+  if(h == nullptr)
+    h.reset(new histogram(bounds));
+
+  return *h;
+}
+
+std::string
+eows::core::metrics_registry::expose() const
+{
+  std::ostringstream out;
+
+  out.imbue(std::locale::classic());
+
+  std::lock_guard<std::mutex> lock(mtx_);
+
+  for(const auto& entry : families_)
+  {
+    const std::string& name = entry.first;
+    const family_t& f = entry.second;
+
+    out << "# HELP " << name << ' ' << f.help << '\n';
+
+    switch(f.kind)
+    {
+      case counter_kind:
+        out << "# TYPE " << name << " counter\n";
+
+        for(const auto& c : f.counters)
+          write_sample(out, name, c.first, c.second->value());
+
+        break;
+
+      case gauge_kind:
+        out << "# TYPE " << name << " gauge\n";
+
+        for(const auto& g : f.gauges)
+          write_sample(out, name, g.first, g.second->value());
+
+        break;
+
+      case histogram_kind:
+        out << "# TYPE " << name << " histogram\n";
+
+        for(const auto& h : f.histograms)
+        {
+          const histogram::snapshot_t snapshot = h.second->snapshot();
+          const std::vector<double>& bounds = h.second->bounds();
+
+          const std::string prefix = h.first.empty() ? std::string() : h.first + ',';
+
+// bucket counts are cumulative in the exposition format
+          uint64_t cumulative = 0;
+
+          for(std::size_t i = 0; i != bounds.size(); ++i)
+          {
+            cumulative += snapshot.counts[i];
+
+            std::ostringstream le;
+            le.imbue(std::locale::classic());
+            le << bounds[i];
+
+            write_sample(out, name + "_bucket", prefix + "le=\"" + le.str() + '"', cumulative);
+          }
+
+          cumulative += snapshot.counts.back();
+
+          write_sample(out, name + "_bucket", prefix + "le=\"+Inf\"", cumulative);
+
+          out.precision(std::numeric_limits<double>::max_digits10);
+          write_sample(out, name + "_sum", h.first, snapshot.sum);
+          out.precision(6);
+
+          write_sample(out, name + "_count", h.first, cumulative);
+        }
+
+        break;
+    }
+  }
+
+  return out.str();
+}
+
+eows::core::metrics_registry&
+eows::core::metrics_registry::instance()
+{
+  static metrics_registry inst;
+
+  return inst;
+}
+
+void
+eows::core::metrics_handler::do_get(const http_request& req, http_response& res)
+{
+  std::string body = metrics_registry::instance().expose();
+
+  res.set_status(http_response::OK);
+  res.add_header(http_response::CONTENT_TYPE, "text/plain; version=0.0.4; charset=utf-8");
+  res.add_header(http_response::ACCESS_CONTROL_ALLOW_ORIGIN, "*");
+
+  res.write(std::move(body));
+}
@@ -0,0 +1,269 @@
+/*
+  Copyright (C) 2017 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of Earth Observation Web Services (EOWS).
+
+  EOWS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 3 as
+  published by the Free Software Foundation.
+
+  EOWS is distributed  "AS-IS" in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY OF ANY KIND; without even the implied warranty
+  of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with EOWS. See LICENSE. If not, write to
+  e-sensing team at <esensing-team@dpi.inpe.br>.
+ */
+
+/*!
+  \file eows/core/metrics.hpp
+
+  \brief Counters, gauges and histograms exposed in the Prometheus text format.
+ */
+
+#ifndef __EOWS_CORE_METRICS_HPP__
+#define __EOWS_CORE_METRICS_HPP__
+
+// EOWS
+#include "web_service_handler.hpp"
+
+// STL
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Boost
+#include <boost/noncopyable.hpp>
+
+namespace eows
+{
+  namespace core
+  {
+
+    //! Metric labels as a list of name and value pairs.
+    typedef std::vector<std::pair<std::string, std::string> > metric_labels_t;
+
+    //! Number of shards of each metric: threads update different shards and never wait for each other.
+    const std::size_t metric_shards = 16;
+
+    //! Returns the shard of the calling thread.
+    std::size_t metric_shard();
+
+    //! A monotonically increasing count.
+    class counter : public boost::noncopyable
+    {
+      public:
+
+        counter();
+
+        void inc(const uint64_t n = 1)
+        {
+          shards_[metric_shard()].value.fetch_add(n, std::memory_order_relaxed);
+        }
+
+        //! Sums the shards.
+        uint64_t value() const;
+
+      private:
+
+        struct shard_t
+        {
+          std::atomic<uint64_t> value;
+          char padding[64 - sizeof(std::atomic<uint64_t>)];
+        };
+
+        std::unique_ptr<shard_t[]> shards_;
+    };
+
+    //! A value that goes up and down, like the number of connections in use.
+    class gauge : public boost::noncopyable
+    {
+      public:
+
+        gauge();
+
+        void add(const int64_t n)
+        {
+          shards_[metric_shard()].value.fetch_add(n, std::memory_order_relaxed);
+        }
+
+        void inc()
+        {
+          add(1);
+        }
+
+        void dec()
+        {
+          add(-1);
+        }
+
+        //! Sums the shards.
+        int64_t value() const;
+
+      private:
+
+        struct shard_t
+        {
+          std::atomic<int64_t> value;
+          char padding[64 - sizeof(std::atomic<int64_t>)];
+        };
+
+        std::unique_ptr<shard_t[]> shards_;
+    };
+
+    /*!
+      \class histogram
+
+      \brief Counts observations in fixed buckets, from which Prometheus estimates quantiles.
+
+      Each bucket counts the observations not greater than its upper bound;
+      larger ones fall in the implicit +Inf bucket.
+     */
+    class histogram : public boost::noncopyable
+    {
+      public:
+
+        //! The state of the histogram at some moment: counts are not cumulative and the last one is the +Inf bucket.
+        struct snapshot_t
+        {
+          std::vector<uint64_t> counts;
+          double sum;
+        };
+
+        //! \param bounds The bucket upper bounds, in increasing order.
+        explicit histogram(const std::vector<double>& bounds);
+
+        void observe(const double value);
+
+        const std::vector<double>& bounds() const
+        {
+          return bounds_;
+        }
+
+        //! Sums the shards.
+        snapshot_t snapshot() const;
+
+      private:
+
+        struct shard_t
+        {
+          explicit shard_t(const std::size_t nbuckets);
+
+          std::unique_ptr<std::atomic<uint64_t>[]> counts;
+          std::atomic<double> sum;
+        };
+
+        std::vector<double> bounds_;
+        std::vector<std::unique_ptr<shard_t> > shards_;  //!< Allocated one by one, so they don't share cache lines
+    };
+
+    //! Bucket bounds, in seconds, from 1 ms to 1 min.
+    const std::vector<double>& latency_buckets();
+
+    //! Observes the time since its construction, in seconds, when destroyed.
+    class latency_timer : public boost::noncopyable
+    {
+      public:
+
+        explicit latency_timer(histogram& h)
+          : histogram_(h),
+            start_(std::chrono::steady_clock::now())
+        {
+        }
+
+        ~latency_timer()
+        {
+          histogram_.observe(std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count());
+        }
+
+      private:
+
+        histogram& histogram_;
+        std::chrono::steady_clock::time_point start_;
+    };
+
+    /*!
+      \class metrics_registry
+
+      \brief A singleton keeping the metrics of the server.
+
+      Metrics live until the end of the program, so callers may keep the
+      returned references and update them without any lock. Only looking a
+      metric up takes the registry lock: hot paths should do it once.
+     */
+    class metrics_registry : public boost::noncopyable
+    {
+      public:
+
+        //! Returns the counter with the given name and labels, creating it if needed.
+        counter& get_counter(const std::string& name, const std::string& help,
+                             const metric_labels_t& labels = metric_labels_t());
+
+        //! Returns the gauge with the given name and labels, creating it if needed.
+        gauge& get_gauge(const std::string& name, const std::string& help,
+                         const metric_labels_t& labels = metric_labels_t());
+
+        /*!
+          \brief Returns the histogram with the given name and labels, creating it if needed.
+
+          \exception std::invalid_argument If the name is in use by another kind of metric.
+         */
+        histogram& get_histogram(const std::string& name, const std::string& help,
+                                 const metric_labels_t& labels = metric_labels_t(),
+                                 const std::vector<double>& bounds = latency_buckets());
+
+        //! Writes every metric in the Prometheus text exposition format (version 0.0.4).
+        std::string expose() const;
+
+        //! Access the singleton.
+        static metrics_registry& instance();
+
+      private:
+
+        enum kind_t
+        {
+          counter_kind,
+          gauge_kind,
+          histogram_kind
+        };
+
+        struct family_t
+        {
+          kind_t kind;
+          std::string help;
+          std::map<std::string, std::unique_ptr<counter> > counters;      //!< Indexed by the formatted labels
+          std::map<std::string, std::unique_ptr<gauge> > gauges;
+          std::map<std::string, std::unique_ptr<histogram> > histograms;
+        };
+
+        metrics_registry() = default;
+
+        family_t& family(const std::string& name, const std::string& help, const kind_t kind);
+
+      private:
+
+        mutable std::mutex mtx_;
+        std::map<std::string, family_t> families_;
+    };
+
+    //! Answers GET requests with the metrics of the server.
+    class metrics_handler : public web_service_handler
+    {
+      public:
+
+        void do_get(const http_request& req, http_response& res);
+    };
+
+  }  // end namespace core
+}    // end namespace eows
+
+#endif  // __EOWS_CORE_METRICS_HPP__
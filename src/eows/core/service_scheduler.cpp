@@ -0,0 +1,170 @@
+/*
+  Copyright (C) 2017 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of Earth Observation Web Services (EOWS).
+
+  EOWS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 3 as
+  published by the Free Software Foundation.
+
+  EOWS is distributed  "AS-IS" in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY OF ANY KIND; without even the implied warranty
+  of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with EOWS. See LICENSE. If not, write to
+  e-sensing team at <esensing-team@dpi.inpe.br>.
+ */
+
+
+/*!
+  \file eows/core/service_scheduler.cpp
+
+  \brief Per-service concurrency limits, with a bounded waiting queue.
+ */
+
+// EOWS
+#include "service_scheduler.hpp"
+#include "exception.hpp"
+
+// STL
+#include <chrono>
+
+// Boost
+#include <boost/format.hpp>
+
+struct eows::core::service_scheduler::service_t
+{
+  service_limits_t limits;
+  std::size_t running = 0;
+  std::size_t waiting = 0;
+  std::condition_variable released;
+};
+
+eows::core::service_scheduler::slot::slot()
+  : owner_(nullptr),
+    service_(nullptr)
+{
+}
+
+eows::core::service_scheduler::slot::slot(service_scheduler* owner, service_t* service)
+  : owner_(owner),
+    service_(service)
+{
+}
+
+eows::core::service_scheduler::slot::slot(slot&& other)
+  : owner_(other.owner_),
+    service_(other.service_)
+{
+  other.owner_ = nullptr;
+  other.service_ = nullptr;
+}
+
+eows::core::service_scheduler::slot&
+eows::core::service_scheduler::slot::operator=(slot&& other)
+{
+  if(this != &other)
+  {
+    release();
+
+    owner_ = other.owner_;
+    service_ = other.service_;
+
+    other.owner_ = nullptr;
+    other.service_ = nullptr;
+  }
+
+  return *this;
+}
+
+eows::core::service_scheduler::slot::~slot()
+{
+  release();
+}
+
+void
+eows::core::service_scheduler::slot::release()
+{
+  if(owner_ != nullptr)
+    owner_->release(service_);
+
+  owner_ = nullptr;
+  service_ = nullptr;
+}
+
+void
+eows::core::service_scheduler::configure(const std::string& path, const service_limits_t& limits)
+{
+  std::lock_guard<std::mutex> lock(mtx_);
+
+  std::unique_ptr<service_t>& service = services_[path];
+
+  if(service == nullptr)
+    service.reset(new service_t);
+
+  service->limits = limits;
+}
+
+eows::core::service_scheduler::slot
+eows::core::service_scheduler::acquire(const std::string& path)
+{
+  std::unique_lock<std::mutex> lock(mtx_);
+
+  auto it = services_.find(path);
+
+  if((it == services_.end()) || (it->second->limits.max_concurrent == 0))
+    return slot();
+
+  service_t* service = it->second.get();
+
+  const service_limits_t& limits = service->limits;
+
+  if(service->running < limits.max_concurrent)
+  {
+    ++service->running;
+
+    return slot(this, service);
+  }
+
+  boost::format err_msg("Service '%1%' is busy. Please, try again later.");
+
+  if(service->waiting >= limits.max_queue)
+    throw service_unavailable_error((err_msg % path).str(), limits.retry_after);
+
+  ++service->waiting;
+
+  const bool admitted = service->released.wait_for(lock,
+                                                   std::chrono::milliseconds(limits.queue_timeout),
+                                                   [service]() { return service->running < service->limits.max_concurrent; });
+
+  --service->waiting;
+
+  if(!admitted)
+    throw service_unavailable_error((err_msg % path).str(), limits.retry_after);
+
+  ++service->running;
+
+  return slot(this, service);
+}
+
+eows::core::service_scheduler&
+eows::core::service_scheduler::instance()
+{
+  static service_scheduler singleton;
+
+  return singleton;
+}
+
+void
+eows::core::service_scheduler::release(service_t* service)
+{
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+
+    --service->running;
+  }
+
+  service->released.notify_one();
+}
@@ -0,0 +1,126 @@
+/*
+  Copyright (C) 2017 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of Earth Observation Web Services (EOWS).
+
+  EOWS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 3 as
+  published by the Free Software Foundation.
+
+  EOWS is distributed  "AS-IS" in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY OF ANY KIND; without even the implied warranty
+  of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with EOWS. See LICENSE. If not, write to
+  e-sensing team at <esensing-team@dpi.inpe.br>.
+ */
+
+
+/*!
+  \file eows/core/service_scheduler.hpp
+
+  \brief Per-service concurrency limits, with a bounded waiting queue.
+ */
+
+#ifndef __EOWS_CORE_SERVICE_SCHEDULER_HPP__
+#define __EOWS_CORE_SERVICE_SCHEDULER_HPP__
+
+// STL
+#include <condition_variable>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+// Boost
+#include <boost/noncopyable.hpp>
+
+namespace eows
+{
+  namespace core
+  {
+
+    //! Limits of the requests of a service.
+    struct service_limits_t
+    {
+      std::size_t max_concurrent = 0;  //!< Requests running at the same time. 0 means no limit
+      std::size_t max_queue = 0;       //!< Requests waiting for a running one to finish
+      std::size_t queue_timeout = 0;   //!< Time a request waits, in milliseconds
+      std::size_t retry_after = 1;     //!< Seconds a rejected client is asked to wait
+    };
+
+    /*!
+      \class service_scheduler
+
+      \brief Bounds how many requests of each service run at the same time.
+
+      A slow service can then hold only a few of the server threads, leaving
+      the others to the remaining services. Requests over the limit wait in a
+      bounded queue; when the queue is full or the wait times out, they are
+      rejected with service_unavailable_error instead of piling up.
+     */
+    class service_scheduler : public boost::noncopyable
+    {
+      public:
+
+        struct service_t;
+
+        //! A running request. The service gets its place back when the slot is destroyed.
+        class slot : public boost::noncopyable
+        {
+          public:
+
+            slot();
+
+            slot(slot&& other);
+
+            slot& operator=(slot&& other);
+
+            ~slot();
+
+          private:
+
+            friend class service_scheduler;
+
+            slot(service_scheduler* owner, service_t* service);
+
+            void release();
+
+            service_scheduler* owner_;
+            service_t* service_;
+        };
+
+        //! Set the limits of a service path. It must be called before serving requests.
+        void configure(const std::string& path, const service_limits_t& limits);
+
+        /*!
+          \brief Takes a place among the running requests of a service, waiting for one if needed.
+
+          Paths without limits always get a place.
+
+          \exception eows::core::service_unavailable_error If the queue is full or the wait timed out.
+         */
+        slot acquire(const std::string& path);
+
+        //! Access the singleton.
+        static service_scheduler& instance();
+
+      private:
+
+        service_scheduler() = default;
+
+        void release(service_t* service);
+
+      private:
+
+        std::mutex mtx_;
+        std::map<std::string, std::unique_ptr<service_t> > services_;
+    };
+
+  }  // end namespace core
+}    // end namespace eows
+
+#endif  // __EOWS_CORE_SERVICE_SCHEDULER_HPP__
@@ -0,0 +1,134 @@
+/*
+  Copyright (C) 2017 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of Earth Observation Web Services (EOWS).
+
+  EOWS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 3 as
+  published by the Free Software Foundation.
+
+  EOWS is distributed  "AS-IS" in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY OF ANY KIND; without even the implied warranty
+  of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with EOWS. See LICENSE. If not, write to
+  e-sensing team at <esensing-team@dpi.inpe.br>.
+ */
+
+
+/*!
+  \file eows/core/single_flight.hpp
+
+  \brief A class for coalescing concurrent executions of the same work.
+ */
+
+#ifndef __EOWS_CORE_SINGLE_FLIGHT_HPP__
+#define __EOWS_CORE_SINGLE_FLIGHT_HPP__
+
+// STL
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+// Boost
+#include <boost/noncopyable.hpp>
+
+namespace eows
+{
+  namespace core
+  {
+
+    /*!
+      \class single_flight
+
+      \brief Makes concurrent calls with the same key share a single execution.
+
+      The first caller for a given key runs the work. Callers arriving with
+      the same key while it is still running wait for it and receive the same
+      result, or the same exception. Once the work finishes, the key is released
+      and the next call starts a new execution: results are not cached.
+     */
+    template<class T>
+    class single_flight : public boost::noncopyable
+    {
+      public:
+
+        typedef std::shared_ptr<const T> result_ptr;
+
+        /*!
+          \brief Run f or wait for an execution of the same key that is already in flight.
+
+          \param key A key identifying the work.
+          \param f   A callable returning a result_ptr.
+
+          \return The result of the execution.
+
+          \exception Any exception thrown by f.
+         */
+        template<class F>
+        result_ptr run(const std::string& key, F&& f);
+
+      private:
+
+        std::mutex mtx_;
+        std::map<std::string, std::shared_future<result_ptr> > in_flight_;
+    };
+
+    template<class T> template<class F>
+    typename single_flight<T>::result_ptr
+    single_flight<T>::run(const std::string& key, F&& f)
+    {
+      std::unique_lock<std::mutex> lock(mtx_);
+
+      auto it = in_flight_.find(key);
+
+// someone is already doing this work: wait for its result
+      if(it != in_flight_.end())
+      {
+        std::shared_future<result_ptr> fut = it->second;
+
+        lock.unlock();
+
+        return fut.get();
+      }
+
+      std::promise<result_ptr> p;
+
+      in_flight_.insert(std::make_pair(key, p.get_future().share()));
+
+      lock.unlock();
+
+      result_ptr r;
+
+      try
+      {
+        r = f();
+
+        p.set_value(r);
+      }
+      catch(...)
+      {
+        p.set_exception(std::current_exception());
+
+        lock.lock();
+
+        in_flight_.erase(key);
+
+        throw;
+      }
+
+      lock.lock();
+
+      in_flight_.erase(key);
+
+      return r;
+    }
+
+  }  // end namespace core
+}    // end namespace eows
+
+#endif  // __EOWS_CORE_SINGLE_FLIGHT_HPP__
@@ -0,0 +1,113 @@
+/*
+  Copyright (C) 2017 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of Earth Observation Web Services (EOWS).
+
+  EOWS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 3 as
+  published by the Free Software Foundation.
+
+  EOWS is distributed  "AS-IS" in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY OF ANY KIND; without even the implied warranty
+  of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with EOWS. See LICENSE. If not, write to
+  e-sensing team at <esensing-team@dpi.inpe.br>.
+ */
+
+
+/*!
+  \file eows/core/task_pool.cpp
+
+  \brief A fixed set of worker threads running tasks from a bounded queue.
+ */
+
+// EOWS
+#include "task_pool.hpp"
+#include "logger.hpp"
+
+// STL
+#include <exception>
+#include <string>
+
+eows::core::task_pool::task_pool(const std::size_t nthreads, const std::size_t max_queue)
+  : idle_(0),
+    max_queue_(max_queue),
+    stopped_(false)
+{
+  for(std::size_t i = 0; i < nthreads; ++i)
+    workers_.emplace_back(&task_pool::run, this);
+}
+
+eows::core::task_pool::~task_pool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+
+    stopped_ = true;
+  }
+
+  ready_.notify_all();
+
+  for(std::thread& worker: workers_)
+    worker.join();
+}
+
+bool
+eows::core::task_pool::try_submit(task_t&& task)
+{
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+
+// queued tasks are first taken by the idle workers: only the remaining ones wait for a busy worker
+    if(stopped_ || (tasks_.size() >= idle_ + max_queue_))
+      return false;
+
+    tasks_.push_back(std::move(task));
+  }
+
+  ready_.notify_one();
+
+  return true;
+}
+
+void
+eows::core::task_pool::run()
+{
+  while(true)
+  {
+    task_t task;
+
+    {
+      std::unique_lock<std::mutex> lock(mtx_);
+
+      ++idle_;
+
+      ready_.wait(lock, [this]() { return stopped_ || !tasks_.empty(); });
+
+      --idle_;
+
+      if(tasks_.empty())
+        return;
+
+      task = std::move(tasks_.front());
+
+      tasks_.pop_front();
+    }
+
+    try
+    {
+      task();
+    }
+    catch(const std::exception& e)
+    {
+      EOWS_LOG_ERROR(std::string("Unhandled error in task: ") + e.what());
+    }
+    catch(...)
+    {
+      EOWS_LOG_ERROR("Unhandled error in task.");
+    }
+  }
+}
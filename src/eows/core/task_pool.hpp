@@ -0,0 +1,98 @@
+/*
+  Copyright (C) 2017 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of Earth Observation Web Services (EOWS).
+
+  EOWS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 3 as
+  published by the Free Software Foundation.
+
+  EOWS is distributed  "AS-IS" in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY OF ANY KIND; without even the implied warranty
+  of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with EOWS. See LICENSE. If not, write to
+  e-sensing team at <esensing-team@dpi.inpe.br>.
+ */
+
+
+/*!
+  \file eows/core/task_pool.hpp
+
+  \brief A fixed set of worker threads running tasks from a bounded queue.
+ */
+
+#ifndef __EOWS_CORE_TASK_POOL_HPP__
+#define __EOWS_CORE_TASK_POOL_HPP__
+
+// STL
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Boost
+#include <boost/noncopyable.hpp>
+
+namespace eows
+{
+  namespace core
+  {
+
+    /*!
+      \class task_pool
+
+      \brief Runs tasks on its own threads, so that the submitting threads are free to go on.
+
+      Submitting never blocks: a task goes straight to an idle worker and waits
+      in the queue only when all the workers are busy. When the queue is full
+      too, the task is refused and the caller must reject the work.
+     */
+    class task_pool : public boost::noncopyable
+    {
+      public:
+
+        typedef std::function<void()> task_t;
+
+        /*!
+          \param nthreads  Number of worker threads.
+          \param max_queue Number of tasks that may wait for a busy worker. With 0, tasks are only run by idle workers.
+         */
+        task_pool(const std::size_t nthreads, const std::size_t max_queue);
+
+        //! Runs the tasks already queued and joins the workers.
+        ~task_pool();
+
+        /*!
+          \brief Hands a task to an idle worker or queues it, unless the queue is full.
+
+          \note Exceptions thrown by the task are discarded: it must handle its own errors.
+
+          \return False if the task was refused.
+         */
+        bool try_submit(task_t&& task);
+
+      private:
+
+        void run();
+
+      private:
+
+        std::mutex mtx_;
+        std::condition_variable ready_;
+        std::deque<task_t> tasks_;
+        std::vector<std::thread> workers_;
+        std::size_t idle_;       //!< Workers waiting for a task.
+        std::size_t max_queue_;
+        bool stopped_;
+    };
+
+  }  // end namespace core
+}    // end namespace eows
+
+#endif  // __EOWS_CORE_TASK_POOL_HPP__
@@ -28,20 +28,30 @@
 // EOWS
 #include "utils.hpp"
 #include "app_settings.hpp"
+#include "compressed_response.hpp"
 #include "defines.hpp"
 #include "exception.hpp"
 #include "http_request.hpp"
+#include "http_response.hpp"
+#include "log_sink.hpp"
 #include "logger.hpp"
+#include "metrics.hpp"
+#include "service_operations_manager.hpp"
+#include "service_scheduler.hpp"
 #include "web_service_handler.hpp"
 
 // STL
+#include <cstring>
 #include <fstream>
+#include <iterator>
+#include <unordered_map>
 
 // Boost
+#include <boost/algorithm/string/predicate.hpp>
 #include <boost/log/attributes/current_thread_id.hpp>
 #include <boost/log/sources/severity_channel_logger.hpp>
 #include <boost/log/utility/setup/common_attributes.hpp>
-#include <boost/log/utility/setup/file.hpp>
+#include <boost/log/utility/setup/formatter_parser.hpp>
 #include <boost/log/trivial.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/format.hpp>
@@ -49,8 +59,233 @@
 // RapiJSON
 #include <rapidjson/istreamwrapper.h>
 
-BOOST_LOG_ATTRIBUTE_KEYWORD(channel, "Channel", std::string)
 
+//! Reads the optional 'log' key of the configuration file: how the log file is written
+static eows::core::log_settings_t
+read_log_settings(const rapidjson::Document& doc)
+{
+  eows::core::log_settings_t settings;
+
+  rapidjson::Value::ConstMemberIterator jlog = doc.FindMember("log");
+
+  if(jlog == doc.MemberEnd())
+    return settings;
+
+  if(!jlog->value.IsObject())
+    throw eows::parse_error("Key 'log' must be a valid JSON object in file '" EOWS_CONFIG_FILE "'.");
+
+  const rapidjson::Value& jsettings = jlog->value;
+
+  rapidjson::Value::ConstMemberIterator jit = jsettings.FindMember("level");
+
+  if(jit != jsettings.MemberEnd())
+  {
+    const std::string level = eows::core::read_node_as_string(jit->value);
+
+    if(!boost::log::trivial::from_string(level.c_str(), level.size(), settings.level))
+      throw eows::parse_error("Please check key 'log.level' in file '" EOWS_CONFIG_FILE "'. It must be one of: trace, debug, info, warning, error or fatal.");
+  }
+
+  jit = jsettings.FindMember("async");
+
+  if(jit != jsettings.MemberEnd())
+  {
+    if(!jit->value.IsBool())
+      throw eows::parse_error("Please check key 'log.async' in file '" EOWS_CONFIG_FILE "'.");
+
+    settings.async = jit->value.GetBool();
+  }
+
+  jit = jsettings.FindMember("queue_size");
+
+  if(jit != jsettings.MemberEnd())
+  {
+    if(!jit->value.IsUint64() || jit->value.GetUint64() == 0)
+      throw eows::parse_error("Please check key 'log.queue_size' in file '" EOWS_CONFIG_FILE "'.");
+
+    settings.queue_size = static_cast<std::size_t>(jit->value.GetUint64());
+  }
+
+  jit = jsettings.FindMember("overflow");
+
+  if(jit != jsettings.MemberEnd())
+  {
+    const std::string overflow = eows::core::read_node_as_string(jit->value);
+
+    if(overflow == "drop")
+      settings.overflow = eows::core::log_settings_t::drop;
+    else if(overflow == "block")
+      settings.overflow = eows::core::log_settings_t::block;
+    else if(overflow == "drop_below_warning")
+      settings.overflow = eows::core::log_settings_t::drop_below_warning;
+    else
+      throw eows::parse_error("Please check key 'log.overflow' in file '" EOWS_CONFIG_FILE "'. It must be one of: drop, block or drop_below_warning.");
+  }
+
+  jit = jsettings.FindMember("flush_interval");
+
+  if(jit != jsettings.MemberEnd())
+  {
+    if(!jit->value.IsUint64())
+      throw eows::parse_error("Please check key 'log.flush_interval' in file '" EOWS_CONFIG_FILE "'.");
+
+    settings.flush_interval = static_cast<std::size_t>(jit->value.GetUint64());
+  }
+
+  return settings;
+}
+
+//! Reads the optional 'http_compression' key of the configuration file
+static void
+initialize_compression(const rapidjson::Document& doc)
+{
+  rapidjson::Value::ConstMemberIterator jcompression = doc.FindMember("http_compression");
+
+  if(jcompression == doc.MemberEnd())
+    return;
+
+  if(!jcompression->value.IsObject())
+    throw eows::parse_error("Key 'http_compression' must be a valid JSON object in file '" EOWS_CONFIG_FILE "'.");
+
+  const rapidjson::Value& jsettings = jcompression->value;
+
+  eows::core::compression_settings_t settings = eows::core::compressed_response::settings();
+
+  rapidjson::Value::ConstMemberIterator jit = jsettings.FindMember("enabled");
+
+  if(jit != jsettings.MemberEnd())
+  {
+    if(!jit->value.IsBool())
+      throw eows::parse_error("Please check key 'http_compression.enabled' in file '" EOWS_CONFIG_FILE "'.");
+
+    settings.enabled = jit->value.GetBool();
+  }
+
+  jit = jsettings.FindMember("min_size");
+
+  if(jit != jsettings.MemberEnd())
+  {
+    if(!jit->value.IsUint64())
+      throw eows::parse_error("Please check key 'http_compression.min_size' in file '" EOWS_CONFIG_FILE "'.");
+
+    settings.min_size = static_cast<std::size_t>(jit->value.GetUint64());
+  }
+
+  jit = jsettings.FindMember("level");
+
+  if(jit != jsettings.MemberEnd())
+  {
+    if(!jit->value.IsInt() || jit->value.GetInt() < 1 || jit->value.GetInt() > 9)
+      throw eows::parse_error("Please check key 'http_compression.level' in file '" EOWS_CONFIG_FILE "'. It must be between 1 and 9.");
+
+    settings.level = jit->value.GetInt();
+  }
+
+  jit = jsettings.FindMember("types");
+
+  if(jit != jsettings.MemberEnd())
+  {
+    if(!jit->value.IsArray())
+      throw eows::parse_error("Please check key 'http_compression.types' in file '" EOWS_CONFIG_FILE "'.");
+
+    settings.types.clear();
+
+    eows::core::copy_string_array(jit->value, std::back_inserter(settings.types));
+  }
+
+  eows::core::compressed_response::configure(settings);
+}
+
+//! Reads a limit of a service in the 'services' key of the configuration file
+static void
+read_service_limit(const rapidjson::Value& jservice, const std::string& path, const char* key, std::size_t& value)
+{
+  rapidjson::Value::ConstMemberIterator jit = jservice.FindMember(key);
+
+  if(jit == jservice.MemberEnd())
+    return;
+
+  if(!jit->value.IsUint64())
+    throw eows::parse_error("Please check key 'services." + path + "." + key + "' in file '" EOWS_CONFIG_FILE "'.");
+
+  value = static_cast<std::size_t>(jit->value.GetUint64());
+}
+
+//! Reads the optional 'services' key of the configuration file: the concurrency limits of each service path
+static void
+initialize_service_limits(const rapidjson::Document& doc)
+{
+  rapidjson::Value::ConstMemberIterator jservices = doc.FindMember("services");
+
+  if(jservices == doc.MemberEnd())
+    return;
+
+  if(!jservices->value.IsObject())
+    throw eows::parse_error("Key 'services' must be a valid JSON object in file '" EOWS_CONFIG_FILE "'.");
+
+  for(rapidjson::Value::ConstMemberIterator jit = jservices->value.MemberBegin(); jit != jservices->value.MemberEnd(); ++jit)
+  {
+    const std::string path = jit->name.GetString();
+
+    if(!jit->value.IsObject())
+      throw eows::parse_error("Key 'services." + path + "' must be a valid JSON object in file '" EOWS_CONFIG_FILE "'.");
+
+    eows::core::service_limits_t limits;
+
+    read_service_limit(jit->value, path, "max_concurrent", limits.max_concurrent);
+    read_service_limit(jit->value, path, "max_queue", limits.max_queue);
+    read_service_limit(jit->value, path, "queue_timeout", limits.queue_timeout);
+    read_service_limit(jit->value, path, "retry_after", limits.retry_after);
+
+    eows::core::service_scheduler::instance().configure(path, limits);
+
+    boost::format msg("Service '%1%' limits: %2% running, %3% waiting up to %4% ms.");
+
+    EOWS_LOG_INFO((msg % path % limits.max_concurrent % limits.max_queue % limits.queue_timeout).str());
+  }
+}
+
+//! Reads the optional 'metrics' key of the configuration file and registers the metrics endpoint
+static void
+initialize_metrics(const rapidjson::Document& doc)
+{
+  bool enabled = true;
+  std::string path = "/metrics";
+
+  rapidjson::Value::ConstMemberIterator jmetrics = doc.FindMember("metrics");
+
+  if(jmetrics != doc.MemberEnd())
+  {
+    if(!jmetrics->value.IsObject())
+      throw eows::parse_error("Key 'metrics' must be a valid JSON object in file '" EOWS_CONFIG_FILE "'.");
+
+    rapidjson::Value::ConstMemberIterator jit = jmetrics->value.FindMember("enabled");
+
+    if(jit != jmetrics->value.MemberEnd())
+    {
+      if(!jit->value.IsBool())
+        throw eows::parse_error("Please check key 'metrics.enabled' in file '" EOWS_CONFIG_FILE "'.");
+
+      enabled = jit->value.GetBool();
+    }
+
+    jit = jmetrics->value.FindMember("path");
+
+    if(jit != jmetrics->value.MemberEnd())
+      path = eows::core::read_node_as_string(jit->value);
+  }
+
+  if(!enabled)
+    return;
+
+  std::unique_ptr<eows::core::metrics_handler> h(new eows::core::metrics_handler);
+
+  eows::core::service_operations_manager::instance().insert(path, std::move(h));
+
+  boost::format msg("Metrics available at '%1%'.");
+
+  EOWS_LOG_INFO((msg % path).str());
+}
 
 void
 eows::core::initialize()
@@ -58,7 +293,9 @@ eows::core::initialize()
 // Find out the log file name and temporary data directory
   const rapidjson::Document& doc = app_settings::instance().get();
 
-  const std::string log_file_name = read_node_as_string(doc, "log_file");
+  log_settings_t log_settings = read_log_settings(doc);
+
+  log_settings.file_name = read_node_as_string(doc, "log_file");
   
 // Prepare log format
   boost::log::register_simple_formatter_factory<boost::log::trivial::severity_level, char>("Severity");
@@ -67,18 +304,10 @@ eows::core::initialize()
 
   boost::log::add_common_attributes();
   
-  const std::string format = "(%ThreadID%) [%TimeStamp%] <%Severity%>: %Message%";
-  const std::string channel_name = "eows";
-  
-  boost::log::add_file_log(boost::log::keywords::auto_flush = true,
-                           boost::log::keywords::format = format,
-                           boost::log::keywords::file_name = log_file_name,
-                           boost::log::keywords::rotation_size = 10 * 1024 * 1024,
-                           boost::log::keywords::scan_method = boost::log::sinks::file::scan_matching,
-                           //boost::log::keywords::open_mode = std::ios_base::app,
-                           boost::log::keywords::channel = channel_name,
-                           boost::log::keywords::filter = (channel == channel_name)
-                          );
+  log_settings.format = "(%ThreadID%) [%TimeStamp%] <%Severity%>: %Message%";
+
+// Records are written by a background thread, unless 'log.async' is false
+  start_file_log(log_settings);
 
   rapidjson::Value::ConstMemberIterator temp_data_it = doc.FindMember("tmp_data_dir");
 
@@ -113,11 +342,29 @@ eows::core::initialize()
 // Setting temporary data directory
   app_settings::instance().set_tmp_data_dir(temp_data_dir);
 
+// Response compression
+  initialize_compression(doc);
+
+// Service concurrency limits
+  initialize_service_limits(doc);
+
+// Metrics endpoint
+  initialize_metrics(doc);
+
   boost::format msg("Using temporary data directory: %1%.");
   EOWS_LOG_INFO((msg % temp_data_dir).str());
   EOWS_LOG_INFO("EOWS core runtime initialized!");
 }
 
+void
+eows::core::finalize()
+{
+  EOWS_LOG_INFO("EOWS core runtime finalized!");
+
+// write the pending log records before the program exits
+  stop_file_log();
+}
+
 std::pair<std::string, std::string>
 eows::core::split_path_and_query_str(const std::string& str)
 {
@@ -183,10 +430,11 @@ eows::core::to_str(content_type_t content_type)
   }
 }
 
-void
-eows::core::process(web_service_handler& handler,
-                    const http_request& request,
-                    http_response& response)
+//! Calls the handler method of the request
+static void
+dispatch(eows::core::web_service_handler& handler,
+         const eows::core::http_request& request,
+         eows::core::http_response& response)
 {
   if(request.method() == "GET")
     handler.do_get(request, response);
@@ -212,6 +460,105 @@ eows::core::process(web_service_handler& handler,
   }
 }
 
+//! The metrics of the requests of a service path and method
+struct request_metrics_t
+{
+  eows::core::histogram* duration;
+  eows::core::counter* rejected;
+};
+
+//! Returns the metrics of a path and method, looking them up in the registry only the first time in each thread
+static const request_metrics_t&
+request_metrics(const std::string& path, const std::string& method)
+{
+  thread_local std::unordered_map<std::string, request_metrics_t> cache;
+
+  std::string key = method + ' ' + path;
+
+  std::unordered_map<std::string, request_metrics_t>::const_iterator it = cache.find(key);
+
+  if(it != cache.end())
+    return it->second;
+
+// unknown methods are rejected by dispatch: keep them from creating new series
+  static const char* const methods[] = { "GET", "POST", "HEAD", "PUT", "DELETE", "TRACE", "CONNECT", "OPTIONS" };
+
+  const bool known = std::find(std::begin(methods), std::end(methods), method) != std::end(methods);
+
+  eows::core::metrics_registry& registry = eows::core::metrics_registry::instance();
+
+  request_metrics_t metrics;
+
+  metrics.duration = &registry.get_histogram("eows_http_request_duration_seconds",
+                                             "Time spent processing requests, by service path and method.",
+                                             {{"path", path}, {"method", known ? method : std::string("OTHER")}});
+
+  metrics.rejected = &registry.get_counter("eows_http_requests_rejected_total",
+                                           "Requests rejected by the service concurrency limits.",
+                                           {{"path", path}});
+
+  return cache.emplace(std::move(key), metrics).first->second;
+}
+
+void
+eows::core::process(web_service_handler& handler,
+                    const http_request& request,
+                    http_response& response)
+{
+  const request_metrics_t& metrics = request_metrics(request.path(), request.method());
+
+  service_scheduler::slot slot;
+
+  try
+  {
+    slot = service_scheduler::instance().acquire(request.path());
+  }
+  catch(const service_unavailable_error& e)
+  {
+    metrics.rejected->inc();
+
+    response.set_status(http_response::service_unavailable);
+    response.add_header("Retry-After", std::to_string(e.retry_after));
+    response.add_header(http_response::CONTENT_TYPE, "text/plain; charset=utf-8");
+    response.add_header(http_response::ACCESS_CONTROL_ALLOW_ORIGIN, "*");
+    response.write(e.what(), std::strlen(e.what()));
+
+    return;
+  }
+
+// the time waiting for a slot is left out: it measures the service alone
+  latency_timer timer(*metrics.duration);
+
+  const compressed_response::coding_t coding = compressed_response::negotiate(find_header(request, "Accept-Encoding"));
+
+  if(coding == compressed_response::identity)
+  {
+    dispatch(handler, request, response);
+    return;
+  }
+
+// the body is compressed as the handler writes it
+  compressed_response compressed(response, coding);
+
+  dispatch(handler, request, compressed);
+
+  compressed.finish();
+}
+
+std::string
+eows::core::find_header(const http_request& request, const std::string& name)
+{
+  const std::map<std::string, std::string> headers = request.headers();
+
+  for(const auto& h : headers)
+  {
+    if(boost::algorithm::iequals(h.first, name))
+      return h.second;
+  }
+
+  return std::string();
+}
+
 rapidjson::Document
 eows::core::open_json_file(const std::string& path)
 {
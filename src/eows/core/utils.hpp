@@ -54,6 +54,9 @@ namespace eows
      */
     void initialize();
 
+    //! Writes the pending log records and closes the log file. Call it before the program exits.
+    void finalize();
+
     /**
      * \brief Tries to find a member by name in RapidJSON Node and then read it as string.
      * \throws eows::parse_error When could not find member name or process as string like
@@ -150,6 +153,11 @@ namespace eows
     void process(web_service_handler& handler,
                  const http_request& request,
                  http_response& response);
+
+    /*!
+      \brief Returns the value of a request header field, compared case-insensitively, or an empty string if not found.
+     */
+    std::string find_header(const http_request& request, const std::string& name);
     
     /*!
       \exception std::invalid_argument If the file can not be opened.
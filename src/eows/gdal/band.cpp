@@ -43,8 +43,6 @@ eows::gdal::band::band(eows::gdal::raster* parent, const std::size_t& id, GDALRa
   datatype_ = gdal_->GetRasterDataType();
   // Generating eows band property
   property_ = make_property(gdal_band, id);
-  // Allocating buffer based in base limits and datatype
-  buffer_ = new unsigned char[block_size()];
 
   switch(datatype_)
   {
@@ -73,8 +71,7 @@ eows::gdal::band::band(eows::gdal::raster* parent, const std::size_t& id, GDALRa
       setter_ = eows::gdal::set_int8;
   }
 
-  // TODO: Remove it.
-  update_buffer_ = true;
+  update_buffer_ = false;
 }
 
 eows::gdal::band::~band()
@@ -97,16 +94,50 @@ eows::gdal::band::~band()
 
 void eows::gdal::band::get_value(const std::size_t& x, const std::size_t& y, double* value)
 {
+  allocate_buffer();
   current_i_ = place_buffer(x, y);
   getter_(current_i_, buffer_, value);
 }
 
 void eows::gdal::band::set_value(const std::size_t& x, const std::size_t& y, double v)
 {
+  allocate_buffer();
   current_i_ = place_buffer(x, y);
   setter_(current_i_, buffer_, &v);
 }
 
+void eows::gdal::band::write(const std::size_t& x, const std::size_t& y, const std::size_t& width, const std::size_t& height,
+                             const void* values, GDALDataType values_datatype)
+{
+  // When the band buffer is in use, it is written in destructor: keep it up to date instead
+  if (buffer_ != nullptr)
+  {
+    const int values_size = GDALGetDataTypeSizeBytes(values_datatype);
+    const int band_size = GDALGetDataTypeSizeBytes(datatype_);
+
+    for(std::size_t row = 0; row != height; ++row)
+    {
+      const unsigned char* src = static_cast<const unsigned char*>(values) + row * width * values_size;
+      unsigned char* dst = static_cast<unsigned char*>(buffer_) + ((y + row) * property_->width + x) * band_size;
+
+      GDALCopyWords(const_cast<unsigned char*>(src), values_datatype, values_size,
+                    dst, datatype_, band_size, static_cast<int>(width));
+    }
+
+    return;
+  }
+
+  CPLErr flag = gdal_->RasterIO(GF_Write,
+                                static_cast<int>(x), static_cast<int>(y),
+                                static_cast<int>(width), static_cast<int>(height),
+                                const_cast<void*>(values),
+                                static_cast<int>(width), static_cast<int>(height),
+                                values_datatype, 0, 0);
+
+  if (flag != CE_None)
+    throw gdal_error("Could not write window into band " + std::to_string(id_));
+}
+
 std::size_t eows::gdal::band::block_size()
 {
   const int block_width = property_->width;
@@ -120,6 +151,16 @@ std::size_t eows::gdal::band::block_size()
   return blksize;
 }
 
+void eows::gdal::band::set_description(const std::string& desc)
+{
+  gdal_->SetDescription(desc.c_str());
+}
+
+void eows::gdal::band::set_no_data(double value)
+{
+  gdal_->SetNoDataValue(value);
+}
+
 eows::gdal::property* eows::gdal::band::make_property(GDALRasterBand* gdalband, const std::size_t index)
 {
   if (gdalband == nullptr)
@@ -145,6 +186,27 @@ void eows::gdal::band::write(std::size_t col, std::size_t row)
   update_buffer_ = false;
 }
 
+void eows::gdal::band::allocate_buffer()
+{
+  if (buffer_ != nullptr)
+    return;
+
+  // Allocating buffer based in base limits and datatype
+  std::unique_ptr<unsigned char[]> buffer(new unsigned char[block_size()]());
+
+  // Loading pixels already in dataset, since whole buffer is written back in destructor
+  int x = property_->width;
+  int y = property_->height;
+  CPLErr flag = gdal_->RasterIO(GF_Read, 0, 0, x, y, buffer.get(), x, y, datatype_, 0, 0);
+
+  if (flag != CE_None)
+    throw gdal_error("Could not read band " + std::to_string(id_) + " into buffer");
+
+  buffer_ = buffer.release();
+
+  update_buffer_ = true;
+}
+
 int eows::gdal::band::place_buffer(int col, int row)
 {
   current_x_ = col / property_->width;
@@ -28,7 +28,10 @@
 #ifndef __EOWS_GDAL_BAND_HPP__
 #define __EOWS_GDAL_BAND_HPP__
 
+#include "data_types.hpp"
+
 #include <cstddef>
+#include <string>
 #include <gdal_priv.h>
 
 namespace eows
@@ -64,11 +67,45 @@ namespace eows
          * \param v - Value to append
          */
         void set_value(const std::size_t& x, const std::size_t& y, double v);
+        /*!
+         * \brief It writes a window of pixels from a contiguous buffer, row by row, converting values to the band datatype.
+         *
+         * Values go straight to GDAL with RasterIO, which flushes them block by block through its block cache,
+         * so that no buffer with the band size is needed.
+         *
+         * \throws eows::gdal::gdal_error When GDAL could not write the window
+         * \param x - Window first column
+         * \param y - Window first row
+         * \param width - Window number of columns
+         * \param height - Window number of rows
+         * \param values - Buffer with width * height values
+         */
+        template<class T>
+        void write(const std::size_t& x, const std::size_t& y, const std::size_t& width, const std::size_t& height, const T* values)
+        {
+          write(x, y, width, height, values, gdal_datatype<T>::value);
+        }
+        /*!
+         * \brief It writes a window of pixels from a contiguous buffer of a given GDAL datatype.
+         * \throws eows::gdal::gdal_error When GDAL could not write the window
+         */
+        void write(const std::size_t& x, const std::size_t& y, const std::size_t& width, const std::size_t& height,
+                   const void* values, GDALDataType values_datatype);
         /*!
          * \brief Retrieve the size of entire buffer based in width, height and type value.
          * \return Size of band
          */
         std::size_t block_size();
+        /*!
+         * \brief It sets the band description, shown by GDAL tools as the band name.
+         * \param desc - Band description
+         */
+        void set_description(const std::string& desc);
+        /*!
+         * \brief It sets the value of the band pixels that have no data.
+         * \param value - No data value
+         */
+        void set_no_data(double value);
       private:
         /*!
          * \brief It creates a EOWS Band property based in GDALRasterType.
@@ -91,6 +128,15 @@ namespace eows
          * \return Index to insert
          */
         int place_buffer(int col, int row);
+        /*!
+         * \brief It allocates the band buffer used by get_value and set_value on first use
+         *
+         * The buffer is loaded with the band pixels, so that windows already written with RasterIO are kept when the
+         * buffer is saved back in destructor.
+         *
+         * \throws eows::gdal::gdal_error When GDAL could not read the band
+         */
+        void allocate_buffer();
 
       private:
         std::size_t id_; //!< Band id
@@ -102,7 +148,7 @@ namespace eows
         raster* parent_; //!< Raster containing GDAL Dataset
         GDALDataType datatype_; //!< GDAL datatype
         GDALRasterBand* gdal_; //!< GDAL band
-        void* buffer_; //!< Buffer to store raw raster data
+        void* buffer_; //!< Buffer to store raw raster data. Only allocated if get_value or set_value are used
         bool update_buffer_; //!< Flag to determines if it should save
 
         int current_x_;   //!< Block x position.
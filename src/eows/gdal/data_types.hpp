@@ -34,10 +34,65 @@
 
 #include <gdal_priv.h>
 
+#include <cstdint>
+#include <string>
+
 namespace eows
 {
   namespace gdal
   {
+    /*!
+     * \brief Maps a C++ type to the GDAL datatype used to transfer its values with RasterIO.
+     *
+     * \note GDAL has no signed 8-bit type: int8 values are transferred as GDT_Byte, like the band buffers do.
+     */
+    template<class T> struct gdal_datatype;
+
+    template<> struct gdal_datatype<int8_t>   { static const GDALDataType value = GDT_Byte; };
+    template<> struct gdal_datatype<uint8_t>  { static const GDALDataType value = GDT_Byte; };
+    template<> struct gdal_datatype<int16_t>  { static const GDALDataType value = GDT_Int16; };
+    template<> struct gdal_datatype<uint16_t> { static const GDALDataType value = GDT_UInt16; };
+    template<> struct gdal_datatype<int32_t>  { static const GDALDataType value = GDT_Int32; };
+    template<> struct gdal_datatype<uint32_t> { static const GDALDataType value = GDT_UInt32; };
+    template<> struct gdal_datatype<float>    { static const GDALDataType value = GDT_Float32; };
+    template<> struct gdal_datatype<double>   { static const GDALDataType value = GDT_Float64; };
+
+    /*!
+     * \brief Describes how a GeoTIFF dataset is encoded. Defaults produce an uncompressed stripped GeoTIFF.
+     */
+    struct creation_options
+    {
+      std::string compression; //!< GDAL COMPRESS value: NONE, PACKBITS, LZW, DEFLATE or ZSTD. Empty uses driver default
+      int predictor;           //!< GDAL PREDICTOR value: 1 (none), 2 (horizontal differencing) or 3 (floating point)
+      bool tiled;              //!< Tiled layout instead of strips
+      int block_width;         //!< Tile width, multiple of 16
+      int block_height;        //!< Tile height, multiple of 16
+      std::string interleave;  //!< PIXEL or BAND. Empty uses driver default
+      std::string num_threads; //!< Number of compression threads or ALL_CPUS. Empty compresses in the calling thread
+      bool cog;                //!< Cloud Optimized GeoTIFF layout, with internal overviews
+
+      creation_options()
+        : predictor(1), tiled(false), block_width(256), block_height(256), cog(false)
+      {
+      }
+    };
+
+    /*!
+     * \brief Describes how a raster is reprojected when it is written. An empty target keeps the raster grid.
+     */
+    struct warp_options
+    {
+      std::string target_wkt;  //!< Spatial reference of the output, in WKT
+      std::string resampling;  //!< GDAL resampling: near, bilinear, cubic, cubicspline, lanczos, average or mode
+      std::string num_threads; //!< Number of warping threads or ALL_CPUS. Empty warps in the calling thread
+      double memory_limit;     //!< Size of the chunks warped at a time, in bytes. 0 uses GDAL default
+
+      warp_options()
+        : resampling("near"), memory_limit(0)
+      {
+      }
+    };
+
     /*!
      * \brief Defines a EOWS Raster Band property containing metadata information like dummy value, eows data type, etc.
      */
@@ -95,6 +150,8 @@ namespace eows
         {
           case eows::geoarray::datatype_t::int8_dt:
             return GDT_Byte;
+          case eows::geoarray::datatype_t::uint8_dt:
+            return GDT_Byte;
           case eows::geoarray::datatype_t::int16_dt:
             return GDT_Int16;
           case eows::geoarray::datatype_t::uint16_dt:
@@ -102,7 +159,11 @@ namespace eows
           case eows::geoarray::datatype_t::int32_dt:
             return GDT_Int32;
           case eows::geoarray::datatype_t::uint32_dt:
-            return GDT_Int32;
+            return GDT_UInt32;
+          // GDAL has no 64-bit integer bands before 3.5
+          case eows::geoarray::datatype_t::int64_dt:
+          case eows::geoarray::datatype_t::uint64_dt:
+            return GDT_Float64;
           case eows::geoarray::datatype_t::float_dt:
             return GDT_Float32;
           case eows::geoarray::datatype_t::double_dt:
@@ -31,9 +31,91 @@
 #include "exception.hpp"
 #include "data_types.hpp"
 
+// GDAL
+#include <cpl_string.h>
+#include <cpl_vsi.h>
+#include <gdalwarper.h>
+
 // STL
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 
+//! Builds GTiff driver creation options
+static char** make_gtiff_options(const eows::gdal::creation_options& options)
+{
+  char** gdal_options = nullptr;
+
+  if (!options.compression.empty())
+    gdal_options = CSLSetNameValue(gdal_options, "COMPRESS", options.compression.c_str());
+
+  if (options.predictor != 1)
+    gdal_options = CSLSetNameValue(gdal_options, "PREDICTOR", std::to_string(options.predictor).c_str());
+
+  if (options.tiled)
+  {
+    gdal_options = CSLSetNameValue(gdal_options, "TILED", "YES");
+    gdal_options = CSLSetNameValue(gdal_options, "BLOCKXSIZE", std::to_string(options.block_width).c_str());
+    gdal_options = CSLSetNameValue(gdal_options, "BLOCKYSIZE", std::to_string(options.block_height).c_str());
+  }
+
+  if (!options.interleave.empty())
+    gdal_options = CSLSetNameValue(gdal_options, "INTERLEAVE", options.interleave.c_str());
+
+  if (!options.num_threads.empty())
+    gdal_options = CSLSetNameValue(gdal_options, "NUM_THREADS", options.num_threads.c_str());
+
+  gdal_options = CSLSetNameValue(gdal_options, "BIGTIFF", "IF_SAFER");
+
+  return gdal_options;
+}
+
+//! Builds COG driver creation options
+static char** make_cog_options(const eows::gdal::creation_options& options)
+{
+  char** gdal_options = nullptr;
+
+  if (!options.compression.empty())
+    gdal_options = CSLSetNameValue(gdal_options, "COMPRESS", options.compression.c_str());
+
+  if (options.predictor == 2)
+    gdal_options = CSLSetNameValue(gdal_options, "PREDICTOR", "STANDARD");
+  else if (options.predictor == 3)
+    gdal_options = CSLSetNameValue(gdal_options, "PREDICTOR", "FLOATING_POINT");
+
+  // COG tiles are square
+  gdal_options = CSLSetNameValue(gdal_options, "BLOCKSIZE", std::to_string(options.block_width).c_str());
+
+  if (!options.num_threads.empty())
+    gdal_options = CSLSetNameValue(gdal_options, "NUM_THREADS", options.num_threads.c_str());
+
+  gdal_options = CSLSetNameValue(gdal_options, "OVERVIEWS", "AUTO");
+  gdal_options = CSLSetNameValue(gdal_options, "BIGTIFF", "IF_SAFER");
+
+  return gdal_options;
+}
+
+//! Maps a GDAL resampling name to the warper algorithm
+static GDALResampleAlg make_resample_alg(const std::string& resampling)
+{
+  if (resampling.empty() || resampling == "near")
+    return GRA_NearestNeighbour;
+  if (resampling == "bilinear")
+    return GRA_Bilinear;
+  if (resampling == "cubic")
+    return GRA_Cubic;
+  if (resampling == "cubicspline")
+    return GRA_CubicSpline;
+  if (resampling == "lanczos")
+    return GRA_Lanczos;
+  if (resampling == "average")
+    return GRA_Average;
+  if (resampling == "mode")
+    return GRA_Mode;
+
+  throw eows::gdal::gdal_error("Unsupported resampling method '" + resampling + "'");
+}
+
 eows::gdal::raster::raster()
   : bands_(), dataset_(nullptr), metadata_(nullptr)
 {
@@ -42,7 +124,11 @@ eows::gdal::raster::raster()
 
 eows::gdal::raster::~raster()
 {
-  close();
+  // An abandoned raster is discarded: there is no need to warp or encode the staging dataset
+  close_dataset(false);
+
+  if (!memory_path_.empty())
+    VSIUnlink(memory_path_.c_str());
 }
 
 void eows::gdal::raster::open(const std::string& path, eows::gdal::raster::access_policy policy)
@@ -61,10 +147,17 @@ void eows::gdal::raster::open(const std::string& path, eows::gdal::raster::acces
   raster::get_bands(this, dataset_, bands_);
 }
 
-void eows::gdal::raster::create(const std::string& filename, const std::size_t& col, const std::size_t& row, const std::vector<property>& properties)
+void eows::gdal::raster::create(const std::string& filename, const std::size_t& col, const std::size_t& row, const std::vector<property>& properties,
+                                const creation_options& options, const warp_options& warp)
 {
-  // Getting gdal GeoTiff driver
-  GDALDriver* driver = GetGDALDriverManager()->GetDriverByName("GTiff");
+  // A COG or a reprojected raster can only be written with CreateCopy: stage the raster in a GDAL memory dataset
+  const bool staged = options.cog || !warp.target_wkt.empty();
+
+  GDALDriver* driver = GetGDALDriverManager()->GetDriverByName(staged ? "MEM" : "GTiff");
+
+  if (driver == nullptr)
+    throw gdal_error("Could not find GDAL driver to create data set");
+
   // Setting dataset limits
   col_ = col;
   row_ = row;
@@ -74,35 +167,297 @@ void eows::gdal::raster::create(const std::string& filename, const std::size_t&
 
   // Retrieving base datatype for dataset band
   GDALDataType dataset_type = property::from_datatype(properties[0].dtype);
+
+  char** gdal_options = staged ? nullptr : make_gtiff_options(options);
+
   // Always create raster with one band. Once created, use properties to set respective band types
-  dataset_ = driver->Create(filename.c_str(), col, row, properties.size(), dataset_type, metadata_);
+  dataset_ = driver->Create(staged ? "" : filename.c_str(), col, row, properties.size(), dataset_type, gdal_options);
+
+  CSLDestroy(gdal_options);
 
   if (dataset_ == nullptr)
     throw gdal_error("Could not create data set");
 
   policy_ = access_policy::write;
+  filename_ = filename;
+  options_ = options;
+  warp_ = warp;
 
   raster::get_bands(this, dataset_, bands_);
 }
 
+void eows::gdal::raster::create_in_memory(const std::size_t& col, const std::size_t& row, const std::vector<property>& properties,
+                                          const creation_options& options, const warp_options& warp)
+{
+  // Each in-memory raster needs its own name in the process wide /vsimem/ file system
+  static std::atomic<unsigned long long> counter(0);
+
+  const std::string path = "/vsimem/eows_raster_" + std::to_string(++counter) + ".tiff";
+
+  create(path, col, row, properties, options, warp);
+
+  memory_path_ = path;
+}
+
 void eows::gdal::raster::close()
+{
+  // In-memory content is discarded, so only a raster written to a file is materialized
+  close_dataset(memory_path_.empty());
+
+  if (!memory_path_.empty())
+  {
+    VSIUnlink(memory_path_.c_str());
+    memory_path_.clear();
+  }
+}
+
+void eows::gdal::raster::close(std::string& output)
+{
+  if (memory_path_.empty())
+    throw gdal_error("Could not retrieve raster content: it was not created in memory");
+
+  // GDAL writes the remaining file content when dataset is closed
+  close_dataset(true);
+
+  vsi_l_offset length = 0;
+  // Unlink the in-memory file and take its buffer ownership
+  GByte* data = VSIGetMemFileBuffer(memory_path_.c_str(), &length, TRUE);
+
+  memory_path_.clear();
+
+  if (data == nullptr)
+    throw gdal_error("Could not retrieve in-memory raster content");
+
+  output.assign(reinterpret_cast<const char*>(data), static_cast<std::size_t>(length));
+
+  VSIFree(data);
+}
+
+void eows::gdal::raster::close_dataset(bool materialize)
 {
   // Cleaning up bands
   for(const band* b: bands_)
     delete b;
   bands_.clear();
 
+  if (metadata_ != nullptr)
+  {
+    CSLDestroy(metadata_);
+    metadata_ = nullptr;
+  }
+
   if (dataset_ != nullptr)
   {
-    GDALClose(static_cast<GDALDatasetH>(dataset_));
+    GDALDataset* dataset = dataset_;
     dataset_ = nullptr;
+
+    if (!materialize)
+    {
+      GDALClose(static_cast<GDALDatasetH>(dataset));
+      return;
+    }
+
+    try
+    {
+      if (!warp_.target_wkt.empty())
+      {
+        GDALDataset* warped = warp(dataset);
+
+        GDALClose(static_cast<GDALDatasetH>(dataset));
+
+        dataset = warped;
+      }
+
+      if (options_.cog)
+        write_cog(dataset);
+      else if (!warp_.target_wkt.empty())
+        write_gtiff(dataset);
+    }
+    catch(...)
+    {
+      GDALClose(static_cast<GDALDatasetH>(dataset));
+      throw;
+    }
+
+    GDALClose(static_cast<GDALDatasetH>(dataset));
   }
+}
 
-  if (metadata_ != nullptr)
+void eows::gdal::raster::write_cog(GDALDataset* staging)
+{
+  GDALDriver* driver = GetGDALDriverManager()->GetDriverByName("COG");
+
+  char** gdal_options = nullptr;
+
+  if (driver != nullptr)
   {
-    CSLDestroy(metadata_);
-    metadata_ = nullptr;
+    gdal_options = make_cog_options(options_);
   }
+  else
+  {
+    // GDAL older than 3.1 has no COG driver: build overviews in the staging dataset and copy them in a tiled GeoTIFF
+    driver = GetGDALDriverManager()->GetDriverByName("GTiff");
+
+    std::vector<int> levels;
+
+    for(int level = 2; (static_cast<int>(std::max(col_, row_)) / level) >= options_.block_width; level *= 2)
+      levels.push_back(level);
+
+    if (!levels.empty() &&
+        staging->BuildOverviews("AVERAGE", static_cast<int>(levels.size()), levels.data(), 0, nullptr, nullptr, nullptr) != CE_None)
+      throw gdal_error("Could not build overviews: " + std::string(CPLGetLastErrorMsg()));
+
+    creation_options options = options_;
+    options.tiled = true;
+    options.block_height = options.block_width;
+
+    gdal_options = make_gtiff_options(options);
+    gdal_options = CSLSetNameValue(gdal_options, "COPY_SRC_OVERVIEWS", "YES");
+  }
+
+  GDALDataset* output = driver->CreateCopy(filename_.c_str(), staging, FALSE, gdal_options, nullptr, nullptr);
+
+  CSLDestroy(gdal_options);
+
+  if (output == nullptr)
+    throw gdal_error("Could not write Cloud Optimized GeoTIFF: " + std::string(CPLGetLastErrorMsg()));
+
+  GDALClose(static_cast<GDALDatasetH>(output));
+}
+
+void eows::gdal::raster::write_gtiff(GDALDataset* staging)
+{
+  GDALDriver* driver = GetGDALDriverManager()->GetDriverByName("GTiff");
+
+  if (driver == nullptr)
+    throw gdal_error("Could not find GDAL driver to create data set");
+
+  char** gdal_options = make_gtiff_options(options_);
+
+  GDALDataset* output = driver->CreateCopy(filename_.c_str(), staging, FALSE, gdal_options, nullptr, nullptr);
+
+  CSLDestroy(gdal_options);
+
+  if (output == nullptr)
+    throw gdal_error("Could not write GeoTIFF: " + std::string(CPLGetLastErrorMsg()));
+
+  GDALClose(static_cast<GDALDatasetH>(output));
+}
+
+GDALDataset* eows::gdal::raster::warp(GDALDataset* staging) const
+{
+  const GDALResampleAlg resample_alg = make_resample_alg(warp_.resampling);
+
+  // Computing the output grid: same number of pixels along the diagonal
+  void* transformer = GDALCreateGenImgProjTransformer(staging, staging->GetProjectionRef(),
+                                                      nullptr, warp_.target_wkt.c_str(),
+                                                      FALSE, 0.0, 1);
+
+  if (transformer == nullptr)
+    throw gdal_error("Could not create reprojection: " + std::string(CPLGetLastErrorMsg()));
+
+  double gtransform[6];
+  int width = 0;
+  int height = 0;
+
+  const CPLErr suggested = GDALSuggestedWarpOutput(staging, GDALGenImgProjTransform, transformer, gtransform, &width, &height);
+
+  GDALDestroyGenImgProjTransformer(transformer);
+
+  if (suggested != CE_None)
+    throw gdal_error("Could not compute reprojected extent: " + std::string(CPLGetLastErrorMsg()));
+
+  const int nbands = staging->GetRasterCount();
+
+  GDALDriver* driver = GetGDALDriverManager()->GetDriverByName("MEM");
+
+  if (driver == nullptr)
+    throw gdal_error("Could not find GDAL driver to create data set");
+
+  GDALDataset* output = driver->Create("", width, height, nbands, staging->GetRasterBand(1)->GetRasterDataType(), nullptr);
+
+  if (output == nullptr)
+    throw gdal_error("Could not create reprojected data set");
+
+  output->SetProjection(warp_.target_wkt.c_str());
+  output->SetGeoTransform(gtransform);
+  output->SetMetadata(staging->GetMetadata());
+
+  GDALWarpOptions* options = GDALCreateWarpOptions();
+
+  options->hSrcDS = staging;
+  options->hDstDS = output;
+  options->eResampleAlg = resample_alg;
+  options->dfWarpMemoryLimit = warp_.memory_limit;
+  options->nBandCount = nbands;
+  options->panSrcBands = static_cast<int*>(CPLMalloc(sizeof(int) * nbands));
+  options->panDstBands = static_cast<int*>(CPLMalloc(sizeof(int) * nbands));
+  options->padfSrcNoDataReal = static_cast<double*>(CPLMalloc(sizeof(double) * nbands));
+  options->padfDstNoDataReal = static_cast<double*>(CPLMalloc(sizeof(double) * nbands));
+
+  // Pixels outside the source are filled with no data, when the bands have one
+  bool has_no_data = true;
+
+  for(int i = 0; i < nbands; ++i)
+  {
+    GDALRasterBand* source_band = staging->GetRasterBand(i + 1);
+    GDALRasterBand* target_band = output->GetRasterBand(i + 1);
+
+    int has_value = FALSE;
+    const double no_data = source_band->GetNoDataValue(&has_value);
+
+    has_no_data = has_no_data && has_value;
+
+    options->panSrcBands[i] = i + 1;
+    options->panDstBands[i] = i + 1;
+    options->padfSrcNoDataReal[i] = no_data;
+    options->padfDstNoDataReal[i] = no_data;
+
+    target_band->SetDescription(source_band->GetDescription());
+
+    if (has_value)
+      target_band->SetNoDataValue(no_data);
+  }
+
+  if (!has_no_data)
+  {
+    CPLFree(options->padfSrcNoDataReal);
+    CPLFree(options->padfDstNoDataReal);
+    options->padfSrcNoDataReal = nullptr;
+    options->padfDstNoDataReal = nullptr;
+  }
+
+  options->papszWarpOptions = CSLSetNameValue(options->papszWarpOptions, "INIT_DEST", has_no_data ? "NO_DATA" : "0");
+
+  if (!warp_.num_threads.empty())
+    options->papszWarpOptions = CSLSetNameValue(options->papszWarpOptions, "NUM_THREADS", warp_.num_threads.c_str());
+
+  options->pTransformerArg = GDALCreateGenImgProjTransformer2(staging, output, nullptr);
+  options->pfnTransformer = GDALGenImgProjTransform;
+
+  CPLErr warped = CE_Failure;
+
+  if (options->pTransformerArg != nullptr)
+  {
+    GDALWarpOperation operation;
+
+    // Chunks are warped by NUM_THREADS threads, while the next chunk is read
+    if (operation.Initialize(options) == CE_None)
+      warped = operation.ChunkAndWarpMulti(0, 0, width, height);
+
+    GDALDestroyGenImgProjTransformer(options->pTransformerArg);
+  }
+
+  GDALDestroyWarpOptions(options);
+
+  if (warped != CE_None)
+  {
+    GDALClose(static_cast<GDALDatasetH>(output));
+
+    throw gdal_error("Could not reproject data set: " + std::string(CPLGetLastErrorMsg()));
+  }
+
+  return output;
 }
 
 eows::gdal::band* eows::gdal::raster::get_band(const std::size_t& id) const
@@ -142,6 +497,10 @@ void eows::gdal::raster::set_description(const std::string& desc)
 void eows::gdal::raster::set_metadata(eows::gdal::raster::metadata flag, const std::string& value)
 {
   metadata_ = CSLSetNameValue(metadata_, get_metadata_key(flag).c_str(), value.c_str());
+
+  // GeoTIFF tags are dataset metadata items
+  if (dataset_ != nullptr)
+    dataset_->SetMetadataItem(get_metadata_key(flag).c_str(), value.c_str());
 }
 
 void eows::gdal::raster::set_projection(const std::string& proj_wkt)
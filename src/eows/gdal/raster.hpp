@@ -29,7 +29,11 @@
 #ifndef __EOWS_GDAL_RASTER_HPP__
 #define __EOWS_GDAL_RASTER_HPP__
 
+// EOWS
+#include "band.hpp"
+
 // STL
+#include <string>
 #include <vector>
 
 // GDAL
@@ -118,14 +122,40 @@ namespace eows
          * \param col - Raster axis X
          * \param row - Raster axis Y
          * \param properties - Raster Band properties used to describe each band
+         * \param options - GeoTIFF layout and compression. A COG is staged in memory and written to filename on close
+         * \param warp - Reprojection of the raster. A reprojected raster is staged in memory and warped on close
+         */
+        void create(const std::string& filename, const std::size_t& col, const std::size_t& row, const std::vector<property>& properties,
+                    const creation_options& options = creation_options(), const warp_options& warp = warp_options());
+
+        /*!
+         * \brief It tries to create a new dataset in a GDAL in-memory file (/vsimem/), so that nothing touches the disk.
+         *        Use close(std::string&) to retrieve the encoded file.
+         *
+         * \throws eows::gdal::gdal_error When GDAL could not create a dataset
+         * \param col - Raster axis X
+         * \param row - Raster axis Y
+         * \param properties - Raster Band properties used to describe each band
+         * \param options - GeoTIFF layout and compression
+         * \param warp - Reprojection of the raster
          */
-        void create(const std::string& filename, const std::size_t& col, const std::size_t& row, const std::vector<property>& properties);
+        void create_in_memory(const std::size_t& col, const std::size_t& row, const std::vector<property>& properties,
+                              const creation_options& options = creation_options(), const warp_options& warp = warp_options());
 
         /*!
-         * \brief It tries to close raster dataset.
+         * \brief It tries to close raster dataset. An in-memory file is discarded without being warped or encoded.
+         * \throws eows::gdal::gdal_error When a Cloud Optimized GeoTIFF could not be written
          */
         void close();
 
+        /*!
+         * \brief It closes a raster created with create_in_memory and moves the encoded file bytes to output.
+         *
+         * \throws eows::gdal::gdal_error When the raster was not created in memory or its content could not be retrieved
+         * \param output - String to store the encoded file
+         */
+        void close(std::string& output);
+
         /*!
          * \brief Retrieves eows raster band to be able to manipulate raw object
          * \param id - Band id
@@ -136,6 +166,23 @@ namespace eows
         void set_value(const std::size_t& col, const std::size_t& row, const double& value, const std::size_t id);
         void get_value(const std::size_t& col, const std::size_t& row, const std::size_t id, double* value) const;
 
+        /*!
+         * \brief It writes a window of pixels of a band from a contiguous buffer, row by row.
+         * \throws eows::gdal::gdal_error When GDAL could not write the window
+         * \param id - Band id
+         * \param col - Window first column
+         * \param row - Window first row
+         * \param width - Window number of columns
+         * \param height - Window number of rows
+         * \param values - Buffer with width * height values
+         */
+        template<class T>
+        void write(const std::size_t id, const std::size_t& col, const std::size_t& row,
+                   const std::size_t& width, const std::size_t& height, const T* values)
+        {
+          get_band(id)->write(col, row, width, height, values);
+        }
+
         void transform(const double llx,
                        const double lly,
                        const double urx,
@@ -155,6 +202,32 @@ namespace eows
          * \return String representation of GeoTIFF dataset metadata key
          */
         static const std::string get_metadata_key(metadata flag);
+      private:
+        /*!
+         * \brief It releases bands and closes GDAL dataset, flushing it to its file.
+         * \param materialize - Whether a staging dataset is warped and copied to the output GeoTIFF or just dropped
+         */
+        void close_dataset(bool materialize);
+
+        /*!
+         * \brief It writes the staging dataset as a Cloud Optimized GeoTIFF into the raster file.
+         * \throws eows::gdal::gdal_error When GDAL could not write the file
+         */
+        void write_cog(GDALDataset* staging);
+
+        /*!
+         * \brief It writes the staging dataset as a GeoTIFF into the raster file.
+         * \throws eows::gdal::gdal_error When GDAL could not write the file
+         */
+        void write_gtiff(GDALDataset* staging);
+
+        /*!
+         * \brief It reprojects the staging dataset into a new memory dataset, warping chunks in parallel.
+         * \throws eows::gdal::gdal_error When GDAL could not warp the dataset
+         * \return The reprojected dataset. Caller takes ownership
+         */
+        GDALDataset* warp(GDALDataset* staging) const;
+
       private:
         access_policy policy_;     //!< Access Policy for raster handling
         std::size_t col_;          //!< Y Axis value
@@ -162,6 +235,10 @@ namespace eows
         std::vector<band*> bands_; //!< Raster bands with raw data
         GDALDataset* dataset_;     //!< GDAL dataset object
         char** metadata_;          //!< GDAL dataset metadata
+        std::string memory_path_;  //!< Path of the /vsimem/ file when created in memory
+        std::string filename_;     //!< Raster file path
+        creation_options options_; //!< GeoTIFF layout and compression
+        warp_options warp_;        //!< Reprojection applied on close
     };
   }
 }
@@ -130,7 +130,7 @@ namespace eows
         switch(dt)
         {
           case eows::geoarray::datatype_t::int8_dt:
-            return sizeof(char) * 8;
+            return sizeof(int8_t);
           case eows::geoarray::datatype_t::uint8_dt:
             return sizeof(unsigned char);
           case eows::geoarray::datatype_t::int16_dt:
@@ -226,12 +226,13 @@ namespace eows
       std::string alias;
       int64_t min_idx;
       int64_t max_idx;
+      int64_t chunk_size;  //!< The chunk interval along this dimension in the underlying array (0 if unknown).
       
       /*!
         \exception std::invalid_argument If an invalid range, such as min > max, is informed.
        */
       explicit dimension_t(const int64_t min = 0, const int64_t max = 0)
-        : min_idx(min), max_idx(max)
+        : min_idx(min), max_idx(max), chunk_size(0)
       {
         if(min_idx > max_idx)
         {
@@ -489,6 +490,19 @@ namespace eows
       std::size_t srid;
     };
 
+    /*!
+      \brief A precomputed downsampled copy of a geo-array.
+
+      The level array has the same attributes and time dimension as the base array.
+      Its x and y dimensions start at the same index as the base ones and the
+      cell (min_idx + i) covers the base cells [min_idx + i * factor, min_idx + (i + 1) * factor).
+     */
+    struct pyramid_level_t
+    {
+      std::string name;  //!< SciDB array name.
+      int64_t factor;    //!< Number of base cells along x and y covered by a level cell.
+    };
+
     //! Base metadata of an array.
     struct geoarray_t
     {
@@ -503,6 +517,7 @@ namespace eows
       std::size_t srid;
       timeline_t timeline;
       internal_metadata_t i_meta;
+      std::vector<pyramid_level_t> pyramid;  //!< Downsampled copies, ordered by factor.
     };
 
     struct grid
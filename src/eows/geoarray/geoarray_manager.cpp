@@ -34,6 +34,7 @@
 // STL
 #include <iterator>
 #include <map>
+#include <mutex>
 #include <utility>
 
 // Boost
@@ -41,22 +42,70 @@
 
 struct eows::geoarray::geoarray_manager::impl
 {
-  std::map<std::string, geoarray_t> arrays;
+  std::map<std::string, std::shared_ptr<const geoarray_t> > arrays;
+  std::mutex mtx;
+
+  std::vector<change_listener_t> listeners;
+  std::mutex listeners_mtx;
 };
 
 void
 eows::geoarray::geoarray_manager::insert(const geoarray_t& a)
 {
-  std::map<std::string, geoarray_t>::const_iterator it = pimpl_->arrays.find(a.name);
+  std::shared_ptr<const geoarray_t> array = std::make_shared<geoarray_t>(a);
+
+  std::lock_guard<std::mutex> lock(pimpl_->mtx);
 
-  if(it != std::end(pimpl_->arrays))
+  if(pimpl_->arrays.find(a.name) != std::end(pimpl_->arrays))
   {
     boost::format err_msg("GeoArray '%1%' is already registered.");
     
     throw std::invalid_argument((err_msg % a.name).str());
   }
 
-  pimpl_->arrays.insert(std::make_pair(a.name, a));
+  pimpl_->arrays.insert(std::make_pair(a.name, std::move(array)));
+}
+
+void
+eows::geoarray::geoarray_manager::update(const geoarray_t& a)
+{
+  std::shared_ptr<const geoarray_t> array = std::make_shared<geoarray_t>(a);
+
+  {
+    std::lock_guard<std::mutex> lock(pimpl_->mtx);
+
+    std::map<std::string, std::shared_ptr<const geoarray_t> >::iterator it = pimpl_->arrays.find(a.name);
+
+    if(it == std::end(pimpl_->arrays))
+    {
+      boost::format err_msg("Could not find metadata for array: '%1%'.");
+
+      throw std::invalid_argument((err_msg % a.name).str());
+    }
+
+// requests holding the old metadata keep it alive until they finish
+    it->second.swap(array);
+  }
+
+// listeners run without the arrays lock: they may look the array up
+  std::vector<change_listener_t> listeners;
+
+  {
+    std::lock_guard<std::mutex> lock(pimpl_->listeners_mtx);
+
+    listeners = pimpl_->listeners;
+  }
+
+  for(const change_listener_t& listener : listeners)
+    listener(a.name);
+}
+
+void
+eows::geoarray::geoarray_manager::add_change_listener(change_listener_t listener)
+{
+  std::lock_guard<std::mutex> lock(pimpl_->listeners_mtx);
+
+  pimpl_->listeners.push_back(std::move(listener));
 }
 
 std::vector<std::string>
@@ -71,6 +120,8 @@ eows::geoarray::geoarray_manager::list_arrays() const
 //                 [](const std::map<std::string, geoarray_t>::value_type& v) -> std::string
 //                 { return v.first; });
 
+  std::lock_guard<std::mutex> lock(pimpl_->mtx);
+
   for(const auto& v : pimpl_->arrays)
   {
     arrays.push_back(v.first);
@@ -79,10 +130,12 @@ eows::geoarray::geoarray_manager::list_arrays() const
   return arrays;
 }
 
-const eows::geoarray::geoarray_t&
+std::shared_ptr<const eows::geoarray::geoarray_t>
 eows::geoarray::geoarray_manager::get(const std::string& array_name) const
 {
-  std::map<std::string, geoarray_t>::const_iterator it = pimpl_->arrays.find(array_name);
+  std::lock_guard<std::mutex> lock(pimpl_->mtx);
+
+  std::map<std::string, std::shared_ptr<const geoarray_t> >::const_iterator it = pimpl_->arrays.find(array_name);
 
   if(it == std::end(pimpl_->arrays))
   {
@@ -29,6 +29,8 @@
 #define __EOWS_GEOARRAY_GEOARRAY_MANAGER_HPP__
 
 // STL
+#include <functional>
+#include <memory>
 #include <vector>
 #include <string>
 
@@ -52,23 +54,42 @@ namespace eows
       the name of its cluster. For instance, an array
       named mod13q1 stored in a cluster named chronos will
       be named: chronos:mod13q1.
+
+      Arrays are handed out as shared pointers to immutable metadata:
+      an update replaces the pointer, so requests running meanwhile
+      keep using the metadata they started with.
      */
     class geoarray_manager : public boost::noncopyable
     {
       public:
 
+        //! A function called with the name of a GeoArray whose metadata has changed.
+        typedef std::function<void(const std::string&)> change_listener_t;
+
         /*!
           \exception std::invalid_argument If another array with the same name and data-source is already registered.
          */
         void insert(const geoarray_t& a);
 
+        /*!
+          \brief Replace the metadata of a registered GeoArray and notify the change listeners.
+
+          Listeners are called from the updating thread, after the new metadata is visible.
+
+          \exception std::invalid_argument If no array is found.
+         */
+        void update(const geoarray_t& a);
+
+        //! Register a function to be notified whenever the metadata of a GeoArray changes.
+        void add_change_listener(change_listener_t listener);
+
         //! Returns the list of GeoArrays.
         std::vector<std::string> list_arrays() const;
 
         /*!
           \exception std::invalid_argument If no array is found.
          */
-        const geoarray_t& get(const std::string& array_name) const;
+        std::shared_ptr<const geoarray_t> get(const std::string& array_name) const;
 
         static geoarray_manager& instance();
 
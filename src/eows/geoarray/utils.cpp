@@ -29,11 +29,20 @@
 #include "utils.hpp"
 #include "defines.hpp"
 #include "../core/app_settings.hpp"
+#include "../core/defines.hpp"
 #include "../core/logger.hpp"
 #include "../core/utils.hpp"
 #include "exception.hpp"
 #include "geoarray_manager.hpp"
 
+// STL
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <ctime>
+#include <mutex>
+#include <thread>
+
 // Boost
 #include <boost/filesystem.hpp>
 #include <boost/format.hpp>
@@ -100,6 +109,12 @@ eows::geoarray::read_geo_array(const rapidjson::Value& jgeo_array)
 
   geo_array.i_meta = read_internal_metadata(jit->value);
 
+// pyramid levels are optional
+  jit = jgeo_array.FindMember("pyramid");
+
+  if(jit != jgeo_array.MemberEnd())
+    geo_array.pyramid = read_pyramid(jit->value);
+
   EOWS_LOG_INFO("Metadata about GeoArray: '" + geo_array.name + "' prepared!");
 
   return geo_array;
@@ -193,6 +208,17 @@ eows::geoarray::read_dimension(const rapidjson::Value& jdimension)
   dim.min_idx = eows::core::read_node_as_int64(jdimension, "min_idx");
   dim.max_idx = eows::core::read_node_as_int64(jdimension, "max_idx");
 
+// chunk size is optional
+  rapidjson::Value::ConstMemberIterator jit = jdimension.FindMember("chunk_size");
+
+  if(jit != jdimension.MemberEnd())
+  {
+    if(!jit->value.IsInt64() || (jit->value.GetInt64() <= 0))
+      throw eows::parse_error("Key 'chunk_size' in file '" EOWS_GEOARRAYS_FILE "' must be a positive integer.");
+
+    dim.chunk_size = jit->value.GetInt64();
+  }
+
   return dim;
 }
 
@@ -286,7 +312,42 @@ eows::geoarray::read_internal_metadata(const rapidjson::Value& jinternal_metadat
   return im;
 }
 
-static void load_geoarrays()
+std::vector<eows::geoarray::pyramid_level_t>
+eows::geoarray::read_pyramid(const rapidjson::Value& jpyramid)
+{
+  if(!jpyramid.IsArray())
+    throw eows::parse_error("Key 'pyramid' in file '" EOWS_GEOARRAYS_FILE "' must be an array.");
+
+  std::vector<pyramid_level_t> levels;
+
+  const rapidjson::SizeType nlevels = jpyramid.Size();
+
+  for(rapidjson::SizeType i = 0; i != nlevels; ++i)
+  {
+    const rapidjson::Value& jlevel = jpyramid[i];
+
+    if(!jlevel.IsObject())
+      throw eows::parse_error("File '" EOWS_GEOARRAYS_FILE "' is not valid.");
+
+    pyramid_level_t level;
+
+    level.name = eows::core::read_node_as_string(jlevel, "name");
+    level.factor = eows::core::read_node_as_int64(jlevel, "factor");
+
+    if(level.factor < 2)
+      throw eows::parse_error("Pyramid level '" + level.name + "' in file '" EOWS_GEOARRAYS_FILE "' must have a factor greater than 1.");
+
+    levels.push_back(level);
+  }
+
+  std::sort(levels.begin(), levels.end(),
+            [](const pyramid_level_t& a, const pyramid_level_t& b) { return a.factor < b.factor; });
+
+  return levels;
+}
+
+//! Reads the GeoArrays file. When reloading, registered arrays get their metadata replaced
+static void load_geoarrays(const bool reload)
 {
   boost::filesystem::path cfg_file(eows::core::app_settings::instance().get_base_dir());
   
@@ -304,6 +365,10 @@ static void load_geoarrays()
   if(!jarrays.IsArray())
     throw eows::parse_error("Key 'arrays' in file '" EOWS_GEOARRAYS_FILE "' must be a valid JSON array of objects.");
 
+  eows::geoarray::geoarray_manager& manager = eows::geoarray::geoarray_manager::instance();
+
+  const std::vector<std::string> registered = manager.list_arrays();
+
   for(rapidjson::SizeType i = 0; i < jarrays.Size(); ++i)
   {
     eows::geoarray::geoarray_t geo_array = eows::geoarray::read_geo_array(jarrays[i]);
@@ -318,17 +383,130 @@ static void load_geoarrays()
       continue;
     }
 
-    eows::geoarray::geoarray_manager::instance().insert(geo_array);
+    if(reload && (std::find(registered.begin(), registered.end(), geo_array.name) != registered.end()))
+      manager.update(geo_array);
+    else
+      manager.insert(geo_array);
   }
 
   EOWS_LOG_INFO("Finished reading file '" + cfg_file.string() + "'.");
 }
 
+//! Reloads the GeoArrays file whenever it is modified
+struct geoarrays_watcher_t
+{
+  std::thread thread;
+  std::mutex mtx;
+  std::condition_variable stop_requested;
+  bool stop = false;
+
+  ~geoarrays_watcher_t()
+  {
+    stop_watching();
+  }
+
+  //! Stops and joins the reload thread, if it is running
+  void stop_watching()
+  {
+    if(!thread.joinable())
+      return;
+
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+
+      stop = true;
+    }
+
+    stop_requested.notify_all();
+
+    thread.join();
+  }
+
+  void run(const std::chrono::seconds interval)
+  {
+    boost::filesystem::path cfg_file(eows::core::app_settings::instance().get_base_dir());
+
+    cfg_file /= EOWS_GEOARRAYS_FILE;
+
+    std::time_t last_write = boost::filesystem::last_write_time(cfg_file);
+
+    std::unique_lock<std::mutex> lock(mtx);
+
+    while(!stop_requested.wait_for(lock, interval, [this]() -> bool { return stop; }))
+    {
+      lock.unlock();
+
+      try
+      {
+        const std::time_t write_time = boost::filesystem::last_write_time(cfg_file);
+
+        if(write_time != last_write)
+        {
+          last_write = write_time;
+
+          load_geoarrays(true);
+        }
+      }
+      catch(const std::exception& e)
+      {
+        boost::format err_msg("Could not reload file '%1%': %2%");
+
+        EOWS_LOG_ERROR((err_msg % cfg_file.string() % e.what()).str());
+      }
+
+      lock.lock();
+    }
+  }
+};
+
+static geoarrays_watcher_t geoarrays_watcher;
+
+//! Reads the optional 'geoarray.reload_interval' key, in seconds, of the configuration file
+static std::size_t read_reload_interval()
+{
+  const rapidjson::Document& doc = eows::core::app_settings::instance().get();
+
+  rapidjson::Value::ConstMemberIterator jgeoarray = doc.FindMember("geoarray");
+
+  if(jgeoarray == doc.MemberEnd())
+    return 0;
+
+  if(!jgeoarray->value.IsObject())
+    throw eows::parse_error("Key 'geoarray' must be a valid JSON object in file '" EOWS_CONFIG_FILE "'.");
+
+  rapidjson::Value::ConstMemberIterator jit = jgeoarray->value.FindMember("reload_interval");
+
+  if(jit == jgeoarray->value.MemberEnd())
+    return 0;
+
+  if(!jit->value.IsUint())
+    throw eows::parse_error("Please check key 'geoarray.reload_interval' in file '" EOWS_CONFIG_FILE "'.");
+
+  return jit->value.GetUint();
+}
+
 void eows::geoarray::initialize()
 {
   EOWS_LOG_INFO("Initializing GeoArrays runtime module...");
 
-  load_geoarrays();
+  load_geoarrays(false);
+
+  const std::size_t reload_interval = read_reload_interval();
+
+  if(reload_interval != 0)
+  {
+    geoarrays_watcher.thread = std::thread(&geoarrays_watcher_t::run, &geoarrays_watcher, std::chrono::seconds(reload_interval));
+
+    boost::format msg("File '" EOWS_GEOARRAYS_FILE "' is checked for changes every %1% seconds.");
+
+    EOWS_LOG_INFO((msg % reload_interval).str());
+  }
 
   EOWS_LOG_INFO("GeoArrays runtime module initialized!");
 }
+
+void eows::geoarray::finalize()
+{
+// the reload thread uses the module singletons: it must not outlive them
+  geoarrays_watcher.stop_watching();
+}
@@ -101,6 +101,12 @@ namespace eows
     internal_metadata_t
     read_internal_metadata(const rapidjson::Value& jinternal_metadata);
 
+    /*!
+      \exception eows::parse_error If it is detected a missing key or ill formed item.
+     */
+    std::vector<pyramid_level_t>
+    read_pyramid(const rapidjson::Value& jpyramid);
+
     template<class Writer>
     void write(Writer& writer, const dimension_t& dim);
 
@@ -127,6 +133,9 @@ namespace eows
      */
     void initialize();
 
+    //! Stops the reload of the GeoArrays file. Call it before the program exits.
+    void finalize();
+
   }  // end namespace geoarray
 }    // end namespace eows
 
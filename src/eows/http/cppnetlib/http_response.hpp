@@ -36,7 +36,12 @@
 #include <boost/network/include/http/server.hpp>
 
 // STL
+#include <array>
+#include <cstdio>
+#include <future>
 #include <map>
+#include <memory>
+#include <stdexcept>
 #include <string>
 
 namespace eows
@@ -55,11 +60,14 @@ namespace eows
         public:
 
           http_response(const server_t::connection_ptr& conn)
-            : conn_(conn)
+            : conn_(conn),
+              streaming_(false)
           {
           }
 
           ~http_response() = default;
+
+          using eows::core::http_response::write;
       
           void set_status(status_t new_status)
           {
@@ -84,14 +92,76 @@ namespace eows
               headers_.clear();
             }
             
-            std::string v = value;
-            conn_->write(v);
+            // The body is sent from the caller buffer, which is kept until it is written
+            if(size != 0)
+              send(boost::asio::buffer(value, size));
+          }
+
+          void begin_stream()
+          {
+            headers_.insert(std::make_pair("Transfer-Encoding", "chunked"));
+
+            conn_->set_headers(headers_);
+            headers_.clear();
+
+            streaming_ = true;
+          }
+
+          void write_chunk(const char* value, const std::size_t size)
+          {
+            // A zero sized chunk would end the body
+            if(size == 0)
+              return;
+
+            char size_line[24];
+
+            const int n = std::snprintf(size_line, sizeof(size_line), "%zx\r\n", size);
+
+            // Chunk framing is gathered around the caller buffer instead of being copied with it
+            const std::array<boost::asio::const_buffer, 3> frame = {{ boost::asio::buffer(size_line, n),
+                                                                      boost::asio::buffer(value, size),
+                                                                      boost::asio::buffer("\r\n", 2) }};
+
+            send(frame);
           }
 
+          void end()
+          {
+            if(!streaming_)
+              return;
+
+            streaming_ = false;
+
+            send(boost::asio::buffer("0\r\n\r\n", 5));
+          }
+
+      private:
+
+        //! Writes buffers and waits for them, so a slow client holds back the producer and buffers outlive the write.
+        template<class ConstBufferSequence>
+        void send(const ConstBufferSequence& buffers)
+        {
+          std::promise<boost::system::error_code> written;
+
+          std::future<boost::system::error_code> result = written.get_future();
+
+          conn_->write(buffers,
+                       [&written](const boost::system::error_code& ec)
+                       {
+                         written.set_value(ec);
+                       });
+
+          const boost::system::error_code ec = result.get();
+
+          if(ec)
+            throw std::runtime_error("Could not write response: " + ec.message());
+        }
+
       private:
       
         const server_t::connection_ptr& conn_;
         std::map<std::string, std::string> headers_;
+        bool streaming_;
     };
 
     } // end namespace cppnetlib
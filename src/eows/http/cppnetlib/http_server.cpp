@@ -32,12 +32,14 @@
 #include "../../core/defines.hpp"
 #include "../../core/logger.hpp"
 #include "../../core/service_operations_manager.hpp"
+#include "../../core/task_pool.hpp"
 #include "../../core/utils.hpp"
 #include "http_request.hpp"
 #include "http_response.hpp"
 
 // STL
 #include <cstdlib>
+#include <memory>
 
 // Boost
 #include <boost/filesystem.hpp>
@@ -84,48 +86,81 @@ namespace eows
         }
       };
       
+      //! Runs the service handler of a request and writes its response.
+      static void serve(server_t::request const& req,
+                        const server_t::connection_ptr& conn)
+      {
+        try
+        {
+          http_request req_wrapper(req);
+          http_response res_wrapper(conn);
+
+          eows::core::web_service_handler* h = eows::core::service_operations_manager::instance().get(req_wrapper.path());
+
+          eows::core::process(*h, req_wrapper, res_wrapper);
+        }
+        catch(const std::exception& e)
+        {
+          conn->set_status(server_t::connection::bad_request);
+
+          std::map<std::string, std::string> headers = {
+            {"Content-Type", "text/plain"},
+          };
+
+          conn->set_headers(headers);
+
+          conn->write(std::string(e.what()));
+
+          //std::cerr << e.what() << std::endl;
+        }
+        catch(...)
+        {
+          conn->set_status(server_t::connection::bad_request);
+
+          std::map<std::string, std::string> headers = {
+            {"Content-Type", "text/plain"},
+          };
+
+          conn->set_headers(headers);
+
+          conn->write(std::string("unknown error!"));
+
+          //std::cerr << "unknown error!" << std::endl;
+        }
+      }
+
       struct handler_t
       {
+        //! Pool running the handlers. When null, handlers run on the network threads.
+        eows::core::task_pool* compute = nullptr;
+
         void operator()(server_t::request const& req,
                         const server_t::connection_ptr& conn)
         {
-          try
-          {
-            http_request req_wrapper(req);
-            http_response res_wrapper(conn);
-            
-            eows::core::web_service_handler* h = eows::core::service_operations_manager::instance().get(req_wrapper.path());
-            
-            eows::core::process(*h, req_wrapper, res_wrapper);
-          }
-          catch(const std::exception& e)
-          {
-            conn->set_status(server_t::connection::bad_request);
-        
-            std::map<std::string, std::string> headers = {
-              {"Content-Type", "text/plain"},
-            };
-        
-            conn->set_headers(headers);
-        
-            conn->write(std::string(e.what()));
-        
-            //std::cerr << e.what() << std::endl;
-          }
-          catch(...)
+          if(compute == nullptr)
           {
-            conn->set_status(server_t::connection::bad_request);
-        
-            std::map<std::string, std::string> headers = {
-              {"Content-Type", "text/plain"},
-            };
-        
-            conn->set_headers(headers);
-        
-            conn->write(std::string("unknown error!"));
-        
-            //std::cerr << "unknown error!" << std::endl;
+            serve(req, conn);
+            return;
           }
+
+          // The task keeps the connection open and its own copy of the request
+          std::shared_ptr<server_t::request> task_req = std::make_shared<server_t::request>(req);
+          server_t::connection_ptr task_conn = conn;
+
+          if(compute->try_submit([task_req, task_conn]() { serve(*task_req, task_conn); }))
+            return;
+
+          // Every compute thread is busy and the queue is full
+          conn->set_status(server_t::connection::service_unavailable);
+
+          std::map<std::string, std::string> headers = {
+            {"Content-Type", "text/plain"},
+            {"Retry-After", "1"},
+          };
+
+          conn->set_headers(headers);
+
+          conn->write(std::string("Server is busy. Please, try again later."));
         }
       };
       
@@ -134,6 +169,8 @@ namespace eows
         std::string listen_address;
         std::string listening_port;
         std::size_t threads;
+        std::size_t compute_threads = 0;
+        std::size_t compute_queue = 0;
       };
       
       cppnetlib_info_t load_config()
@@ -170,6 +207,30 @@ namespace eows
           throw eows::parse_error("Please check key 'threads' in file '" EOWS_CONFIG_FILE "'.");
 
         app_cfg.threads = jthreads->value.GetUint();
+
+        rapidjson::Value::ConstMemberIterator jcompute_threads = jcppnetlib.FindMember("compute_threads");
+
+        if(jcompute_threads != jcppnetlib.MemberEnd())
+        {
+          if(!jcompute_threads->value.IsUint())
+            throw eows::parse_error("Please check key 'compute_threads' in file '" EOWS_CONFIG_FILE "'.");
+
+          app_cfg.compute_threads = jcompute_threads->value.GetUint();
+        }
+
+        rapidjson::Value::ConstMemberIterator jcompute_queue = jcppnetlib.FindMember("compute_queue");
+
+        if(jcompute_queue != jcppnetlib.MemberEnd())
+        {
+          if(!jcompute_queue->value.IsUint())
+            throw eows::parse_error("Please check key 'compute_queue' in file '" EOWS_CONFIG_FILE "'.");
+
+          app_cfg.compute_queue = jcompute_queue->value.GetUint();
+        }
+
+        // Without a queue, a request arriving while every compute thread is busy is always refused
+        if((app_cfg.compute_threads != 0) && (app_cfg.compute_queue == 0))
+          throw eows::parse_error("Key 'compute_queue' must be greater than zero when 'compute_threads' is set in file '" EOWS_CONFIG_FILE "'.");
         
         return app_cfg;
       }
@@ -187,6 +248,16 @@ int eows::http::cppnetlib::http_server::run()
     cppnetlib_info_t cfg_info = load_config();
     
     handler_t request_handler;
+
+    // Handlers run on their own threads, leaving the network threads to accept and write
+    std::unique_ptr<eows::core::task_pool> compute;
+
+    if(cfg_info.compute_threads != 0)
+    {
+      compute.reset(new eows::core::task_pool(cfg_info.compute_threads, cfg_info.compute_queue));
+
+      request_handler.compute = compute.get();
+    }
     
     server_t::options options(request_handler);
     
@@ -93,7 +93,10 @@ namespace eows
           std::map<std::string, std::string> headers() const
           {
             std::map<std::string, std::string> headers;
-  
+
+            for(const auto& h : req_.headers)
+              headers.insert(std::make_pair(h.first, h.second));
+
             return headers;
           }
       
@@ -71,9 +71,16 @@ namespace eows
 
           void write(const char* value, const std::size_t size)
           {
-            // Creating a bytearray with correct size
-            std::string bytes(value, size);
-            res_.write(bytes);
+            // Crow sends the body when the handler returns: append it once, with its size
+            res_.body.append(value, size);
+          }
+
+          void write(std::string&& value)
+          {
+            if(res_.body.empty())
+              res_.body = std::move(value);
+            else
+              res_.body.append(value);
           }
 
       private:
@@ -44,20 +44,8 @@ struct ws_handler
     eows::http::crow::http_request req_wrapper(req);
     eows::http::crow::http_response res_wrapper(res);
 
-    switch(req.method)
-    {
-      case crow::HTTPMethod::GET:
-        h_->do_get(req_wrapper, res_wrapper);
-        break;
-
-      case crow::HTTPMethod::POST:
-        h_->do_post(req_wrapper, res_wrapper);
-        break;
-
-      default:
-        break;
-    }
-
+    // Routes accept GET and POST only
+    eows::core::process(*h_, req_wrapper, res_wrapper);
 
     res.end();
   }
@@ -0,0 +1,169 @@
+/*
+  Copyright (C) 2017 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of Earth Observation Web Services (EOWS).
+
+  EOWS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 3 as
+  published by the Free Software Foundation.
+
+  EOWS is distributed  "AS-IS" in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY OF ANY KIND; without even the implied warranty
+  of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with EOWS. See LICENSE. If not, write to
+  e-sensing team at <esensing-team@dpi.inpe.br>.
+ */
+
+
+/*!
+  \file eows/ogc/wcs/core/admission.cpp
+
+  \brief Admission control of GetCoverage requests by their expected response size.
+ */
+
+// EOWS
+#include "admission.hpp"
+#include "../exception.hpp"
+
+// STL
+#include <algorithm>
+#include <chrono>
+#include <string>
+
+// Boost
+#include <boost/format.hpp>
+
+eows::ogc::wcs::core::admission::ticket::ticket()
+  : owner_(nullptr),
+    bytes_(0)
+{
+}
+
+eows::ogc::wcs::core::admission::ticket::ticket(eows::ogc::wcs::core::admission* owner, const std::size_t bytes)
+  : owner_(owner),
+    bytes_(bytes)
+{
+}
+
+eows::ogc::wcs::core::admission::ticket::ticket(ticket&& other)
+  : owner_(other.owner_),
+    bytes_(other.bytes_)
+{
+  other.owner_ = nullptr;
+  other.bytes_ = 0;
+}
+
+eows::ogc::wcs::core::admission::ticket&
+eows::ogc::wcs::core::admission::ticket::operator=(ticket&& other)
+{
+  if(this != &other)
+  {
+    release();
+
+    owner_ = other.owner_;
+    bytes_ = other.bytes_;
+
+    other.owner_ = nullptr;
+    other.bytes_ = 0;
+  }
+
+  return *this;
+}
+
+eows::ogc::wcs::core::admission::ticket::~ticket()
+{
+  release();
+}
+
+std::size_t eows::ogc::wcs::core::admission::ticket::bytes() const
+{
+  return bytes_;
+}
+
+void eows::ogc::wcs::core::admission::ticket::release()
+{
+  if(owner_ != nullptr)
+    owner_->release(bytes_);
+
+  owner_ = nullptr;
+  bytes_ = 0;
+}
+
+eows::ogc::wcs::core::admission::admission()
+  : max_request_size_(0),
+    max_in_flight_size_(0),
+    queue_timeout_(0),
+    in_flight_(0)
+{
+}
+
+void eows::ogc::wcs::core::admission::configure(const std::size_t max_request_size,
+                                                const std::size_t max_in_flight_size,
+                                                const std::size_t queue_timeout)
+{
+  std::lock_guard<std::mutex> lock(mtx_);
+
+  max_request_size_ = max_request_size;
+  max_in_flight_size_ = max_in_flight_size;
+  queue_timeout_ = queue_timeout;
+}
+
+eows::ogc::wcs::core::admission::ticket eows::ogc::wcs::core::admission::admit(const std::size_t bytes)
+{
+  std::unique_lock<std::mutex> lock(mtx_);
+
+  // A request that can never fit is rejected at once
+  if(((max_request_size_ != 0) && (bytes > max_request_size_)) ||
+     ((max_in_flight_size_ != 0) && (bytes > max_in_flight_size_)))
+  {
+    const std::size_t limit = (max_request_size_ == 0) ? max_in_flight_size_
+                                                       : (max_in_flight_size_ == 0) ? max_request_size_
+                                                                                    : std::min(max_request_size_, max_in_flight_size_);
+
+    boost::format err_msg("The expected response size of %1% bytes exceeds the limit of %2% bytes. Request a smaller subset or use scaling");
+
+    throw eows::ogc::wcs::response_too_large_error((err_msg % bytes % limit).str());
+  }
+
+  if(max_in_flight_size_ != 0)
+  {
+    const bool admitted = released_.wait_for(lock, std::chrono::milliseconds(queue_timeout_), [this, bytes]() {
+      return in_flight_ + bytes <= max_in_flight_size_;
+    });
+
+    if(!admitted)
+      throw eows::ogc::wcs::server_busy_error("The server is busy. Try again later");
+  }
+
+  in_flight_ += bytes;
+
+  return ticket(this, bytes);
+}
+
+std::size_t eows::ogc::wcs::core::admission::in_flight() const
+{
+  std::lock_guard<std::mutex> lock(mtx_);
+
+  return in_flight_;
+}
+
+eows::ogc::wcs::core::admission& eows::ogc::wcs::core::admission::instance()
+{
+  static admission singleton;
+
+  return singleton;
+}
+
+void eows::ogc::wcs::core::admission::release(const std::size_t bytes)
+{
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+
+    in_flight_ -= bytes;
+  }
+
+  released_.notify_all();
+}
@@ -0,0 +1,135 @@
+/*
+  Copyright (C) 2017 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of Earth Observation Web Services (EOWS).
+
+  EOWS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 3 as
+  published by the Free Software Foundation.
+
+  EOWS is distributed  "AS-IS" in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY OF ANY KIND; without even the implied warranty
+  of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with EOWS. See LICENSE. If not, write to
+  e-sensing team at <esensing-team@dpi.inpe.br>.
+ */
+
+
+/*!
+  \file eows/ogc/wcs/core/admission.hpp
+
+  \brief Admission control of GetCoverage requests by their expected response size.
+ */
+
+#ifndef __EOWS_OGC_WCS_CORE_ADMISSION_HPP__
+#define __EOWS_OGC_WCS_CORE_ADMISSION_HPP__
+
+// STL
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+
+// Boost
+#include <boost/noncopyable.hpp>
+
+namespace eows
+{
+  namespace ogc
+  {
+    namespace wcs
+    {
+      namespace core
+      {
+        /*!
+         * \brief Limits the size of each response and the total size of the responses being produced.
+         *
+         * A request reserves its expected size before running its SciDB query. When the
+         * in-flight budget is exhausted, it waits for other requests to finish, up to a timeout.
+         * A limit of 0 means no limit.
+         */
+        class admission : private boost::noncopyable
+        {
+          public:
+
+            /*!
+             * \brief Bytes reserved by an admitted request. They are given back when the ticket is destroyed.
+             */
+            class ticket : private boost::noncopyable
+            {
+              public:
+
+                ticket();
+
+                ticket(ticket&& other);
+
+                ticket& operator=(ticket&& other);
+
+                ~ticket();
+
+                //! Returns the number of reserved bytes.
+                std::size_t bytes() const;
+
+              private:
+
+                friend class admission;
+
+                ticket(admission* owner, const std::size_t bytes);
+
+                void release();
+
+                admission* owner_;
+                std::size_t bytes_;
+            };
+
+            /*!
+             * \brief Sets the limits.
+             * \param max_request_size - Maximum expected size of a response, in bytes
+             * \param max_in_flight_size - Maximum expected size of all responses being produced, in bytes
+             * \param queue_timeout - Maximum time a request waits for the in-flight budget, in milliseconds
+             */
+            void configure(const std::size_t max_request_size,
+                           const std::size_t max_in_flight_size,
+                           const std::size_t queue_timeout);
+
+            /*!
+             * \brief Reserves the expected size of a response, waiting for room in the in-flight budget.
+             *
+             * \throws eows::ogc::wcs::response_too_large_error When the size is over the limits
+             * \throws eows::ogc::wcs::server_busy_error When there was no room before the timeout
+             *
+             * \param bytes - Expected response size
+             * \return A ticket holding the reservation
+             */
+            ticket admit(const std::size_t bytes);
+
+            //! Returns the number of bytes reserved by the requests being produced.
+            std::size_t in_flight() const;
+
+            //! Singleton style
+            static admission& instance();
+
+          private:
+
+            admission();
+
+            void release(const std::size_t bytes);
+
+          private:
+
+            mutable std::mutex mtx_;
+            std::condition_variable released_;
+            std::size_t max_request_size_;
+            std::size_t max_in_flight_size_;
+            std::size_t queue_timeout_;
+            std::size_t in_flight_;
+        };
+
+      }  // end namespace core
+    }    // end namespace wcs
+  }      // end namespace ogc
+}        // end namespace eows
+
+#endif  // __EOWS_OGC_WCS_CORE_ADMISSION_HPP__
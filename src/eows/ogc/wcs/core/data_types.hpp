@@ -8,6 +8,7 @@
 #include "../../../geoarray/data_types.hpp"
 
 // STL
+#include <map>
 #include <string>
 #include <vector>
 
@@ -87,6 +88,16 @@ namespace eows
           std::string raw;
           std::vector<std::string> attributes;
         };
+
+        /*!
+         * \brief Represents the WCS Scaling extension parameters given by client. Only one of them may be set.
+         */
+        struct scaling_t
+        {
+          double factor {1.0}; //!< ScaleFactor: same factor on every axis. 1 means no scaling
+          std::map<std::string, double> axes; //!< ScaleAxes: factor of each axis
+          std::map<std::string, std::size_t> sizes; //!< ScaleSize: number of cells of each axis
+        };
       }
     }
   }
@@ -0,0 +1,113 @@
+/*
+  Copyright (C) 2017 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of Earth Observation Web Services (EOWS).
+
+  EOWS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 3 as
+  published by the Free Software Foundation.
+
+  EOWS is distributed  "AS-IS" in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY OF ANY KIND; without even the implied warranty
+  of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with EOWS. See LICENSE. If not, write to
+  e-sensing team at <esensing-team@dpi.inpe.br>.
+ */
+
+
+/*!
+  \file eows/ogc/wcs/core/document_cache.cpp
+
+  \brief A cache of serialized WCS documents that only change with the service configuration.
+ */
+
+// EOWS
+#include "document_cache.hpp"
+
+// STL
+#include <cstdint>
+#include <cstdio>
+
+eows::ogc::wcs::core::document_cache::document_cache()
+  : generation_(0)
+{
+}
+
+eows::ogc::wcs::core::document_ptr
+eows::ogc::wcs::core::document_cache::get(const std::string& key, const std::function<std::string()>& make)
+{
+  std::size_t generation = 0;
+
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+
+    auto it = documents_.find(key);
+
+    if(it != documents_.end())
+      return it->second;
+
+    generation = generation_;
+  }
+
+  // Building out of the lock: two requests may build the same document, but never wait for each other
+  std::shared_ptr<document_t> document(new document_t);
+
+  document->body = make();
+  document->etag = make_etag(document->body);
+
+  std::lock_guard<std::mutex> lock(mtx_);
+
+  // The configuration changed while building: the document is used once but not kept
+  if(generation != generation_)
+    return document;
+
+  auto result = documents_.insert(std::make_pair(key, document_ptr(document)));
+
+  return result.first->second;
+}
+
+void eows::ogc::wcs::core::document_cache::invalidate(const std::string& key)
+{
+  std::lock_guard<std::mutex> lock(mtx_);
+
+  documents_.erase(key);
+
+  ++generation_;
+}
+
+void eows::ogc::wcs::core::document_cache::clear()
+{
+  std::lock_guard<std::mutex> lock(mtx_);
+
+  documents_.clear();
+
+  ++generation_;
+}
+
+std::string eows::ogc::wcs::core::document_cache::make_etag(const std::string& bytes)
+{
+  // 64-bit FNV-1a
+  uint64_t hash = 14695981039346656037ULL;
+
+  for(const char c: bytes)
+  {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 1099511628211ULL;
+  }
+
+  char etag[24];
+
+  std::snprintf(etag, sizeof(etag), "\"%016llx\"", static_cast<unsigned long long>(hash));
+
+  return etag;
+}
+
+eows::ogc::wcs::core::document_cache& eows::ogc::wcs::core::document_cache::instance()
+{
+  static document_cache singleton;
+
+  return singleton;
+}
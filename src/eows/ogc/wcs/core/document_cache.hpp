@@ -0,0 +1,107 @@
+/*
+  Copyright (C) 2017 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of Earth Observation Web Services (EOWS).
+
+  EOWS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 3 as
+  published by the Free Software Foundation.
+
+  EOWS is distributed  "AS-IS" in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY OF ANY KIND; without even the implied warranty
+  of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with EOWS. See LICENSE. If not, write to
+  e-sensing team at <esensing-team@dpi.inpe.br>.
+ */
+
+
+/*!
+  \file eows/ogc/wcs/core/document_cache.hpp
+
+  \brief A cache of serialized WCS documents that only change with the service configuration.
+ */
+
+#ifndef __EOWS_OGC_WCS_CORE_DOCUMENT_CACHE_HPP__
+#define __EOWS_OGC_WCS_CORE_DOCUMENT_CACHE_HPP__
+
+// STL
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+// Boost
+#include <boost/noncopyable.hpp>
+
+namespace eows
+{
+  namespace ogc
+  {
+    namespace wcs
+    {
+      namespace core
+      {
+        /*!
+         * \brief A serialized document and its entity tag.
+         */
+        struct document_t
+        {
+          std::string body; //!< Document bytes
+          std::string etag; //!< Quoted strong entity tag of body
+        };
+
+        typedef std::shared_ptr<const document_t> document_ptr;
+
+        /*!
+         * \brief Keeps immutable serialized documents, built on first use.
+         *
+         * Documents are shared with the requests using them, so that dropping
+         * an entry never invalidates a response being written.
+         */
+        class document_cache : private boost::noncopyable
+        {
+          public:
+
+            /*!
+             * \brief It retrieves the document of a key, building it if it is not cached.
+             *
+             * \param key - Document key
+             * \param make - Function returning the document body. Exceptions are not cached
+             * \return The cached document
+             */
+            document_ptr get(const std::string& key, const std::function<std::string()>& make);
+
+            //! It drops the document of a key.
+            void invalidate(const std::string& key);
+
+            //! It drops every document.
+            void clear();
+
+            /*!
+             * \brief It computes the entity tag of some bytes.
+             * \return A quoted tag, stable across server restarts
+             */
+            static std::string make_etag(const std::string& bytes);
+
+            //! Singleton style
+            static document_cache& instance();
+
+          private:
+
+            document_cache();
+
+            std::mutex mtx_;
+            std::map<std::string, document_ptr> documents_;
+            std::size_t generation_; //!< Changed by every invalidation
+        };
+
+      }  // end namespace core
+    }    // end namespace wcs
+  }      // end namespace ogc
+}        // end namespace eows
+
+#endif  // __EOWS_OGC_WCS_CORE_DOCUMENT_CACHE_HPP__
@@ -28,6 +28,8 @@
 #ifndef __EOWS_OGC_WCS_CORE_OPERATIONS_HPP__
 #define __EOWS_OGC_WCS_CORE_OPERATIONS_HPP__
 
+#include <cstddef>
+#include <functional>
 #include <string>
 
 namespace eows
@@ -45,6 +47,11 @@ namespace eows
         class operation
         {
           public:
+            /**
+             * @brief Receives each piece of the operation output, in order.
+             */
+            typedef std::function<void(const char*, std::size_t)> writer_t;
+
             operation() = default;
 
             virtual ~operation()
@@ -68,6 +75,36 @@ namespace eows
              * @returns string representation of operation
              */
             virtual const std::string& to_string() const = 0;
+
+            /**
+             * @brief It retrieves the entity tag of the operation output, used to answer conditional requests.
+             *
+             * Operations whose output only changes with the service configuration return a
+             * non-empty tag, which may be retrieved before execute.
+             *
+             * @returns A quoted entity tag or an empty string
+             */
+            virtual std::string etag() const
+            {
+              return std::string();
+            }
+
+            /**
+             * @brief It performs the operation, delivering the output to write as it is produced.
+             *
+             * Any error found before the first call to write is thrown as in execute. The default
+             * implementation executes the operation and writes the whole output at once.
+             *
+             * @param write - Output callback
+             */
+            virtual void stream(const writer_t& write)
+            {
+              execute();
+
+              const std::string& output = to_string();
+
+              write(output.data(), output.size());
+            }
         };
       }
     }
@@ -0,0 +1,246 @@
+/*
+  Copyright (C) 2017 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of Earth Observation Web Services (EOWS).
+
+  EOWS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 3 as
+  published by the Free Software Foundation.
+
+  EOWS is distributed  "AS-IS" in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY OF ANY KIND; without even the implied warranty
+  of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with EOWS. See LICENSE. If not, write to
+  e-sensing team at <esensing-team@dpi.inpe.br>.
+ */
+
+
+/*!
+  \file eows/ogc/wcs/core/tuple_list_encoder.cpp
+
+  \brief Encoder of SciDB query results as GML tupleList content.
+ */
+
+// EOWS
+#include "tuple_list_encoder.hpp"
+#include "../exception.hpp"
+#include "../../../core/metrics.hpp"
+#include "../../../geoarray/data_types.hpp"
+#include "../../../scidb/chunk_iterator.hpp"
+
+// STL
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+//! Pairs of decimal digits from "00" to "99"
+static const char digit_pairs[201] =
+  "00010203040506070809"
+  "10111213141516171819"
+  "20212223242526272829"
+  "30313233343536373839"
+  "40414243444546474849"
+  "50515253545556575859"
+  "60616263646566676869"
+  "70717273747576777879"
+  "80818283848586878889"
+  "90919293949596979899";
+
+//! Writes an unsigned integer in decimal, returning the position past its last digit
+static char* write_unsigned(char* out, uint64_t value)
+{
+  char digits[20];
+  char* end = digits + sizeof(digits);
+  char* p = end;
+
+  while(value >= 100)
+  {
+    const unsigned pair = static_cast<unsigned>(value % 100) * 2;
+    value /= 100;
+    *--p = digit_pairs[pair + 1];
+    *--p = digit_pairs[pair];
+  }
+
+  if(value >= 10)
+  {
+    const unsigned pair = static_cast<unsigned>(value) * 2;
+    *--p = digit_pairs[pair + 1];
+    *--p = digit_pairs[pair];
+  }
+  else
+  {
+    *--p = static_cast<char>('0' + value);
+  }
+
+  const std::size_t len = static_cast<std::size_t>(end - p);
+
+  std::memcpy(out, p, len);
+
+  return out + len;
+}
+
+template<class T>
+static char* write_integer(char* out, const unsigned char* column, const std::size_t i, std::true_type /* signed */)
+{
+  T value;
+  std::memcpy(&value, column + i * sizeof(T), sizeof(T));
+
+  if(value >= 0)
+    return write_unsigned(out, static_cast<uint64_t>(value));
+
+  *out++ = '-';
+
+// negate in unsigned arithmetic so that the minimum value does not overflow
+  return write_unsigned(out, 0 - static_cast<uint64_t>(value));
+}
+
+template<class T>
+static char* write_integer(char* out, const unsigned char* column, const std::size_t i, std::false_type /* unsigned */)
+{
+  T value;
+  std::memcpy(&value, column + i * sizeof(T), sizeof(T));
+
+  return write_unsigned(out, static_cast<uint64_t>(value));
+}
+
+template<class T>
+static char* write_integer(char* out, const unsigned char* column, const std::size_t i)
+{
+  return write_integer<T>(out, column, i, std::is_signed<T>());
+}
+
+//! Writes a floating point value with enough digits to read it back exactly
+template<class T>
+static char* write_floating(char* out, const unsigned char* column, const std::size_t i)
+{
+  T value;
+  std::memcpy(&value, column + i * sizeof(T), sizeof(T));
+
+  const int len = std::snprintf(out, 32, "%.*g", std::numeric_limits<T>::max_digits10, static_cast<double>(value));
+
+  return out + len;
+}
+
+eows::ogc::wcs::core::tuple_list_encoder::tuple_list_encoder(const std::vector<std::size_t>& attributes_pos,
+                                                             const std::vector<int>& datatypes,
+                                                             const char ts,
+                                                             const char cs)
+  : attributes_pos_(attributes_pos),
+    max_cell_size_(0),
+    ts_(ts),
+    cs_(cs)
+{
+  for(const int datatype : datatypes)
+  {
+// worst case text size of each datatype, separator included
+    switch(datatype)
+    {
+      case eows::geoarray::datatype_t::int8_dt:
+        writers_.push_back(&write_integer<int8_t>);
+        max_cell_size_ += 5;
+        break;
+      case eows::geoarray::datatype_t::uint8_dt:
+        writers_.push_back(&write_integer<uint8_t>);
+        max_cell_size_ += 4;
+        break;
+      case eows::geoarray::datatype_t::int16_dt:
+        writers_.push_back(&write_integer<int16_t>);
+        max_cell_size_ += 7;
+        break;
+      case eows::geoarray::datatype_t::uint16_dt:
+        writers_.push_back(&write_integer<uint16_t>);
+        max_cell_size_ += 6;
+        break;
+      case eows::geoarray::datatype_t::int32_dt:
+        writers_.push_back(&write_integer<int32_t>);
+        max_cell_size_ += 12;
+        break;
+      case eows::geoarray::datatype_t::uint32_dt:
+        writers_.push_back(&write_integer<uint32_t>);
+        max_cell_size_ += 11;
+        break;
+      case eows::geoarray::datatype_t::int64_dt:
+        writers_.push_back(&write_integer<int64_t>);
+        max_cell_size_ += 21;
+        break;
+      case eows::geoarray::datatype_t::uint64_dt:
+        writers_.push_back(&write_integer<uint64_t>);
+        max_cell_size_ += 21;
+        break;
+      case eows::geoarray::datatype_t::float_dt:
+        writers_.push_back(&write_floating<float>);
+        max_cell_size_ += 32;
+        break;
+      case eows::geoarray::datatype_t::double_dt:
+        writers_.push_back(&write_floating<double>);
+        max_cell_size_ += 32;
+        break;
+      default:
+        throw eows::ogc::wcs::no_such_field_error("Invalid attribute type, got " + eows::geoarray::datatype_t::to_string(datatype));
+    }
+  }
+}
+
+std::size_t
+eows::ogc::wcs::core::tuple_list_encoder::estimate(const std::size_t ncells) const
+{
+// the worst case is far from the typical value size: reserve half of it
+  return ncells * max_cell_size_ / 2;
+}
+
+void
+eows::ogc::wcs::core::tuple_list_encoder::encode(const eows::scidb::chunk_block_t& block, std::string& output) const
+{
+  const std::size_t nattributes = writers_.size();
+
+  if(nattributes == 0)
+    return;
+
+  std::vector<const unsigned char*> columns(nattributes);
+
+  for(std::size_t a = 0; a != nattributes; ++a)
+    columns[a] = block.columns[attributes_pos_[a]].data.data();
+
+// grow output by the chunk worst case and write straight into it
+  const std::size_t used = output.size();
+
+  output.resize(used + block.ncells * max_cell_size_);
+
+  char* begin = &output[0] + used;
+  char* out = begin;
+
+  for(std::size_t i = 0; i != block.ncells; ++i)
+  {
+    out = writers_[0](out, columns[0], i);
+
+    for(std::size_t a = 1; a != nattributes; ++a)
+    {
+      *out++ = cs_;
+      out = writers_[a](out, columns[a], i);
+    }
+
+    *out++ = ts_;
+  }
+
+  output.resize(used + static_cast<std::size_t>(out - begin));
+
+  static eows::core::counter& encoded_bytes = eows::core::metrics_registry::instance().get_counter("eows_encoder_bytes_total", "Bytes written by the response encoders.", {{"encoder", "gml_tuple_list"}});
+
+  encoded_bytes.inc(static_cast<uint64_t>(out - begin));
+}
+
+void
+eows::ogc::wcs::core::tuple_list_encoder::encode(eows::scidb::chunk_iterator& chunk_it, std::string& output) const
+{
+  while(!chunk_it.end())
+  {
+    encode(chunk_it.get_block(), output);
+
+    chunk_it.next();
+  }
+}
@@ -0,0 +1,97 @@
+/*
+  Copyright (C) 2017 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of Earth Observation Web Services (EOWS).
+
+  EOWS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 3 as
+  published by the Free Software Foundation.
+
+  EOWS is distributed  "AS-IS" in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY OF ANY KIND; without even the implied warranty
+  of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with EOWS. See LICENSE. If not, write to
+  e-sensing team at <esensing-team@dpi.inpe.br>.
+ */
+
+
+/*!
+  \file eows/ogc/wcs/core/tuple_list_encoder.hpp
+
+  \brief Encoder of SciDB query results as GML tupleList content.
+ */
+
+#ifndef __EOWS_OGC_WCS_CORE_TUPLE_LIST_ENCODER_HPP__
+#define __EOWS_OGC_WCS_CORE_TUPLE_LIST_ENCODER_HPP__
+
+// STL
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace eows
+{
+  namespace scidb
+  {
+    class chunk_iterator;
+    struct chunk_block_t;
+  }
+
+  namespace ogc
+  {
+    namespace wcs
+    {
+      namespace core
+      {
+        /*!
+         * \brief Writes cells as GML tupleList text straight into an output string.
+         *
+         * Cells are written as "a0 b0 c0,a1 b1 c1,...", with attribute values separated by cs
+         * and cells terminated by ts. Integers are converted without locale or streams and the
+         * output grows one chunk at a time, by the chunk worst case text size.
+         */
+        class tuple_list_encoder
+        {
+          public:
+
+            /*!
+             * \throws eows::ogc::wcs::no_such_field_error When an attribute datatype is not supported
+             * \param attributes_pos - Position of each attribute in the chunk columns, in output order
+             * \param datatypes - EOWS geoarray datatype of each attribute
+             * \param ts - Tuple separator
+             * \param cs - Attribute (coordinate) separator
+             */
+            tuple_list_encoder(const std::vector<std::size_t>& attributes_pos,
+                               const std::vector<int>& datatypes,
+                               const char ts = ',',
+                               const char cs = ' ');
+
+            //! Returns an estimate of the text size of a number of cells, used to reserve the output.
+            std::size_t estimate(const std::size_t ncells) const;
+
+            //! Appends the cells of a chunk to output.
+            void encode(const eows::scidb::chunk_block_t& block, std::string& output) const;
+
+            //! Appends every remaining chunk of the iterator to output.
+            void encode(eows::scidb::chunk_iterator& chunk_it, std::string& output) const;
+
+          private:
+
+            typedef char* (*value_writer_t)(char* out, const unsigned char* column, const std::size_t i);
+
+            std::vector<std::size_t> attributes_pos_;
+            std::vector<value_writer_t> writers_;
+            std::size_t max_cell_size_;  //!< Worst case text size of a cell, separators included
+            char ts_;
+            char cs_;
+        };
+
+      }  // end namespace core
+    }    // end namespace wcs
+  }      // end namespace ogc
+}        // end namespace eows
+
+#endif  // __EOWS_OGC_WCS_CORE_TUPLE_LIST_ENCODER_HPP__
@@ -81,6 +81,28 @@ namespace eows
         {
         }
       };
+
+      /*!
+       * \brief Represents a request whose expected response is larger than the server accepts.
+       */
+      struct response_too_large_error : public virtual wcs_error
+      {
+        response_too_large_error(const std::string& s)
+          : wcs_error(s, "InvalidSubsetting")
+        {
+        }
+      };
+
+      /*!
+       * \brief Represents a request refused because the server is already producing as much as it accepts.
+       */
+      struct server_busy_error : public virtual wcs_error
+      {
+        server_busy_error(const std::string& s)
+          : wcs_error(s, "NoApplicableCode")
+        {
+        }
+      };
     } // end namespace wcs
   }   // end namespace ogc
 }     // end namespace eows
@@ -6,9 +6,12 @@
 #include "../../../core/utils.hpp"
 
 // STL (stringstream parse and find)
+#include <algorithm>
 #include <sstream>
+#include <thread>
 
 // Boost
+#include <boost/algorithm/string/case_conv.hpp>
 #include <boost/algorithm/string/classification.hpp>
 #include <boost/algorithm/string/split.hpp>
 
@@ -73,6 +76,34 @@ eows::ogc::wcs::operations::describe_coverage_request::describe_coverage_request
   coverages_id = sliced_coverages;
 }
 
+//! Reads a GeoTIFF boolean parameter ("true" or "false")
+static bool read_geotiff_flag(const eows::core::query_string_t::const_iterator& it)
+{
+  const std::string value = eows::core::to_lower(it->second);
+
+  if (value == "true")
+    return true;
+
+  if (value != "false")
+    throw eows::ogc::invalid_parameter_error("Invalid value '" + it->second + "' for '" + it->first + "'. Use true or false", "InvalidParameterValue");
+
+  return false;
+}
+
+//! Reads a GeoTIFF positive integer parameter
+static int read_geotiff_size(const eows::core::query_string_t::const_iterator& it)
+{
+  int value = 0;
+
+  std::stringstream stream(it->second);
+  stream >> value;
+
+  if (stream.fail() || !stream.eof() || value <= 0)
+    throw eows::ogc::invalid_parameter_error("Invalid value '" + it->second + "' for '" + it->first + "'. Expected a positive integer", "InvalidParameterValue");
+
+  return value;
+}
+
 void validate_subset(const std::stringstream& ss)
 {
   if (!ss.good())
@@ -97,28 +128,18 @@ eows::ogc::wcs::operations::get_coverage_request::get_coverage_request(const eow
   else
     format = eows::core::from_string(it->second);
 
-  // InputCRS
-  it = query.find("inputcrs");
-  if (it != query.end())
-  {
-    std::stringstream stream;
-    stream << it->second;
-    stream >> input_crs;
-  }
-  else
-    input_crs = 4326;
-
-  it = query.find("outputcrs");
-  if (it != query.end())
-  {
-    std::stringstream stream;
-    stream << it->second;
-    stream >> output_crs;
-  }
+  // CRS extension
+  digest_crs(query);
 
   // Process Subsets
   digest_subset(query);
 
+  // GeoTIFF encoding
+  digest_geotiff(query);
+
+  // Scaling extension
+  digest_scaling(query);
+
   it = query.find("rangesubset");
 
   if (it != query.end())
@@ -128,6 +149,60 @@ eows::ogc::wcs::operations::get_coverage_request::get_coverage_request(const eow
   }
 }
 
+//! Reads a CRS given as an EPSG code, as EPSG:code or as an OGC CRS URI ending with the EPSG code
+static std::size_t read_crs(const std::string& value, const std::string& parameter)
+{
+  const std::size_t code_pos = value.find_last_of("/:");
+
+  std::stringstream stream(code_pos == std::string::npos ? value : value.substr(code_pos + 1));
+
+  std::size_t code = 0;
+  stream >> code;
+
+  if (stream.fail() || !stream.eof() || code == 0)
+    throw eows::ogc::invalid_parameter_error("Invalid value '" + value + "' for '" + parameter + "'. Expected an EPSG CRS", "NotACrs");
+
+  return code;
+}
+
+void eows::ogc::wcs::operations::get_coverage_request::digest_crs(const eows::core::query_string_t& query)
+{
+  // InputCRS: subsettingCrs of CRS extension
+  eows::core::query_string_t::const_iterator it = query.find("subsettingcrs");
+
+  if (it == query.end())
+    it = query.find("inputcrs");
+
+  input_crs = (it == query.end()) ? 4326 : read_crs(it->second, it->first);
+
+  it = query.find("outputcrs");
+
+  if (it != query.end())
+    output_crs = read_crs(it->second, it->first);
+
+  // Interpolation extension: OGC interpolation URI or GDAL resampling name
+  it = query.find("interpolation");
+
+  if (it != query.end())
+  {
+    const std::size_t method_pos = it->second.find_last_of('/');
+    const std::string method = eows::core::to_lower(method_pos == std::string::npos ? it->second : it->second.substr(method_pos + 1));
+
+    if (method == "nearest-neighbor" || method == "near")
+      interpolation = "near";
+    else if (method == "linear" || method == "bilinear")
+      interpolation = "bilinear";
+    else if (method == "cubic")
+      interpolation = "cubic";
+    else if (method == "cubic-spline" || method == "cubicspline")
+      interpolation = "cubicspline";
+    else if (method == "lanczos" || method == "average" || method == "mode")
+      interpolation = method;
+    else
+      throw eows::ogc::invalid_parameter_error("Interpolation method '" + it->second + "' is not supported", "InterpolationMethodNotSupported");
+  }
+}
+
 void eows::ogc::wcs::operations::get_coverage_request::digest_subset(const eows::core::query_string_t& query)
 {
   eows::core::query_string_t::const_iterator begin_it  = query.lower_bound("subset");
@@ -206,3 +281,179 @@ void eows::ogc::wcs::operations::get_coverage_request::digest_subset(const eows:
     }
   }  // end if it(subset) != end()
 }
+
+void eows::ogc::wcs::operations::get_coverage_request::digest_geotiff(const eows::core::query_string_t& query)
+{
+  eows::core::query_string_t::const_iterator it = query.find("geotiff:compression");
+
+  if (it != query.end())
+  {
+    const std::string value = eows::core::to_lower(it->second);
+
+    if (value == "none" || value == "packbits" || value == "lzw" || value == "deflate" || value == "zstd")
+      geotiff.compression = boost::to_upper_copy(value);
+    else
+      throw eows::ogc::invalid_parameter_error("Invalid value '" + it->second + "' for 'geotiff:compression'. Use None, PackBits, LZW, Deflate or ZSTD", "InvalidParameterValue");
+  }
+
+  it = query.find("geotiff:predictor");
+
+  if (it != query.end())
+  {
+    const std::string value = eows::core::to_lower(it->second);
+
+    if (value == "none")
+      geotiff.predictor = 1;
+    else if (value == "horizontal")
+      geotiff.predictor = 2;
+    else if (value == "floatingpoint")
+      geotiff.predictor = 3;
+    else
+      throw eows::ogc::invalid_parameter_error("Invalid value '" + it->second + "' for 'geotiff:predictor'. Use None, Horizontal or FloatingPoint", "InvalidParameterValue");
+  }
+
+  it = query.find("geotiff:interleave");
+
+  if (it != query.end())
+  {
+    const std::string value = eows::core::to_lower(it->second);
+
+    if (value != "pixel" && value != "band")
+      throw eows::ogc::invalid_parameter_error("Invalid value '" + it->second + "' for 'geotiff:interleave'. Use Pixel or Band", "InvalidParameterValue");
+
+    geotiff.interleave = boost::to_upper_copy(value);
+  }
+
+  it = query.find("geotiff:tiling");
+
+  if (it != query.end())
+    geotiff.tiled = read_geotiff_flag(it);
+
+  it = query.find("geotiff:tilewidth");
+
+  if (it != query.end())
+    geotiff.block_width = read_geotiff_size(it);
+
+  it = query.find("geotiff:tileheight");
+
+  if (it != query.end())
+    geotiff.block_height = read_geotiff_size(it);
+
+  if ((geotiff.block_width % 16 != 0) || (geotiff.block_height % 16 != 0))
+    throw eows::ogc::invalid_parameter_error("GeoTIFF tile width and height must be multiples of 16", "InvalidParameterValue");
+
+  it = query.find("geotiff:threads");
+
+  if (it != query.end())
+  {
+    // Never use more threads than the server has cores
+    const int max_threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+    if (eows::core::to_lower(it->second) == "all")
+      geotiff.num_threads = std::to_string(max_threads);
+    else
+      geotiff.num_threads = std::to_string(std::min(read_geotiff_size(it), max_threads));
+  }
+
+  it = query.find("geotiff:cog");
+
+  if (it != query.end())
+    geotiff.cog = read_geotiff_flag(it);
+
+  // COG layout is always tiled with square tiles
+  if (geotiff.cog)
+  {
+    geotiff.tiled = true;
+    geotiff.block_height = geotiff.block_width;
+  }
+}
+
+//! Reads a scale factor, which must be a number not lower than 1
+static double read_scale_factor(const std::string& value, const std::string& parameter)
+{
+  double factor = 0.0;
+
+  std::stringstream stream(value);
+  stream >> factor;
+
+  if (stream.fail() || !stream.eof() || factor <= 0.0)
+    throw eows::ogc::invalid_parameter_error("Invalid value '" + value + "' for '" + parameter + "'. Expected a positive number", "InvalidScaleFactor");
+
+  if (factor < 1.0)
+    throw eows::ogc::invalid_parameter_error("Invalid value '" + value + "' for '" + parameter + "'. Upscaling is not supported", "InvalidScaleFactor");
+
+  return factor;
+}
+
+//! Splits a list like "axis(value),axis(value)" into axis and value pairs
+static std::vector<std::pair<std::string, std::string> > read_scale_axes(const eows::core::query_string_t::const_iterator& it)
+{
+  std::vector<std::string> items;
+
+  boost::split(items, it->second, boost::is_any_of(","));
+
+  std::vector<std::pair<std::string, std::string> > axes;
+
+  for(const std::string& item: items)
+  {
+    const std::size_t open = item.find('(');
+
+    if (open == std::string::npos || open == 0 || item.size() < open + 3 || item.back() != ')')
+      throw eows::ogc::invalid_parameter_error("Invalid value '" + it->second + "' for '" + it->first + "'. Use axis(value),axis(value)", "InvalidParameterValue");
+
+    const std::string axis = item.substr(0, open);
+
+    auto found = std::find_if(axes.begin(), axes.end(), [&axis](const std::pair<std::string, std::string>& elm) {
+      return elm.first == axis;
+    });
+
+    if (found != axes.end())
+      throw eows::ogc::invalid_parameter_error("Axis '" + axis + "' given twice in '" + it->first + "'", "InvalidParameterValue");
+
+    axes.push_back(std::make_pair(axis, item.substr(open + 1, item.size() - open - 2)));
+  }
+
+  return axes;
+}
+
+void eows::ogc::wcs::operations::get_coverage_request::digest_scaling(const eows::core::query_string_t& query)
+{
+  const std::size_t given = query.count("scalefactor") + query.count("scaleaxes") + query.count("scalesize") + query.count("scaleextent");
+
+  if (given > 1)
+    throw eows::ogc::invalid_parameter_error("Only one of ScaleFactor, ScaleAxes, ScaleSize or ScaleExtent may be given", "InvalidParameterValue");
+
+  if (query.count("scaleextent") != 0)
+    throw eows::ogc::not_implemented_error("ScaleExtent is not supported", "OperationNotSupported");
+
+  eows::core::query_string_t::const_iterator it = query.find("scalefactor");
+
+  if (it != query.end())
+    scaling.factor = read_scale_factor(it->second, it->first);
+
+  it = query.find("scaleaxes");
+
+  if (it != query.end())
+  {
+    for(const auto& axis: read_scale_axes(it))
+      scaling.axes[axis.first] = read_scale_factor(axis.second, it->first);
+  }
+
+  it = query.find("scalesize");
+
+  if (it != query.end())
+  {
+    for(const auto& axis: read_scale_axes(it))
+    {
+      long long size = 0;
+
+      std::stringstream stream(axis.second);
+      stream >> size;
+
+      if (stream.fail() || !stream.eof() || size <= 0)
+        throw eows::ogc::invalid_parameter_error("Invalid value '" + axis.second + "' for '" + it->first + "'. Expected a positive integer", "InvalidExtent");
+
+      scaling.sizes[axis.first] = static_cast<std::size_t>(size);
+    }
+  }
+}
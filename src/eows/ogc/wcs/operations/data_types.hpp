@@ -33,6 +33,8 @@
 #include "../core/data_types.hpp"
 // EOWS Core
 #include "../../../core/data_types.hpp"
+// EOWS GDAL
+#include "../../../gdal/data_types.hpp"
 
 // STL
 #include <string>
@@ -92,12 +94,46 @@ namespace eows
            */
           void digest_subset(const eows::core::query_string_t& query);
 
+          /*!
+           * \brief It process CRS extension parameters (subsettingcrs/inputcrs and outputcrs) and the interpolation method.
+           *
+           * A CRS may be an EPSG code, EPSG:code or an OGC URI like http://www.opengis.net/def/crs/EPSG/0/4326.
+           *
+           * \throws eows::ogc::invalid_parameter_error When a CRS or the interpolation method is not valid
+           * \param query - Query string
+           */
+          void digest_crs(const eows::core::query_string_t& query);
+
+          /*!
+           * \brief It process GeoTIFF encoding parameters (OGC WCS GeoTIFF Coverage Encoding Profile).
+           *
+           * Besides geotiff:compression, geotiff:predictor, geotiff:interleave, geotiff:tiling, geotiff:tilewidth and
+           * geotiff:tileheight, it accepts ZSTD compression, geotiff:threads (number or "all") and geotiff:cog (true/false).
+           *
+           * \throws eows::ogc::invalid_parameter_error When a parameter value is not supported
+           * \param query - Query string
+           */
+          void digest_geotiff(const eows::core::query_string_t& query);
+
+          /*!
+           * \brief It process WCS Scaling extension parameters: scalefactor, scaleaxes and scalesize.
+           *
+           * Only downscaling is supported: factors must be at least 1. The axis names are checked against the coverage later.
+           *
+           * \throws eows::ogc::invalid_parameter_error When a parameter value is not valid
+           * \param query - Query string
+           */
+          void digest_scaling(const eows::core::query_string_t& query);
+
           std::string coverage_id; //!< Coverage Identifier
           eows::core::content_type_t format; //!< Response format output
           std::size_t input_crs; //!< InputCRS of subsetting
-          std::size_t output_crs {4326}; //!< OutputCRS of operation. Default: 4326
+          std::size_t output_crs {0}; //!< OutputCRS of operation. Default: 0, the coverage native CRS
+          std::string interpolation; //!< GDAL resampling of a reprojected coverage. Empty uses the server default
           std::vector<eows::ogc::wcs::core::subset_t> subsets; //!< Client subsets to retrieve coverage portion
           eows::ogc::wcs::core::range_subset_t range_subset; //!< Coverage attributes to perform slice
+          eows::gdal::creation_options geotiff; //!< GeoTIFF layout and compression
+          eows::ogc::wcs::core::scaling_t scaling; //!< Client downscaling
         };
       }
     }
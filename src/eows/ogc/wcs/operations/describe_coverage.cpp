@@ -30,6 +30,7 @@
 #include "../core/data_types.hpp"
 #include "data_types.hpp"
 #include "../manager.hpp"
+#include "../core/document_cache.hpp"
 #include "../core/utils.hpp"
 #include "../../../core/logger.hpp"
 
@@ -37,6 +38,9 @@
 #include "../../../geoarray/data_types.hpp"
 #include "../../../geoarray/geoarray_manager.hpp"
 
+// STL
+#include <cassert>
+
 // RapidXML
 #include <rapidxml/rapidxml.hpp>
 #include <rapidxml/rapidxml_print.hpp>
@@ -49,11 +53,44 @@ struct eows::ogc::wcs::operations::describe_coverage::impl
 
   }
 
+  //! It retrieves the cached documents of the requested coverages
+  void load();
+
   eows::ogc::wcs::operations::describe_coverage_request request;
+  //!< Cached wcs:CoverageDescriptions document, with a marker in place of its content
+  eows::ogc::wcs::core::document_ptr envelope;
+  //!< Cached wcs:CoverageDescription of each requested coverage
+  std::vector<eows::ogc::wcs::core::document_ptr> descriptions;
   std::string xml_representation;
   std::string format;
 };
 
+//! Key of the DescribeCoverage envelope in the WCS document cache
+static const std::string descriptions_document_key("DescribeCoverage");
+
+//! Placeholder printed in wcs:CoverageDescriptions and replaced by the coverage descriptions
+static const std::string descriptions_marker("@EOWS_COVERAGE_DESCRIPTIONS@");
+
+//! It serializes the wcs:CoverageDescriptions element, with descriptions_marker as content
+static std::string make_descriptions_envelope();
+
+//! It serializes the wcs:CoverageDescription of a coverage
+static std::string make_coverage_description(const std::string& array_name);
+
+void eows::ogc::wcs::operations::describe_coverage::impl::load()
+{
+  if (envelope != nullptr)
+    return;
+
+  eows::ogc::wcs::core::document_cache& cache = eows::ogc::wcs::core::document_cache::instance();
+
+  for(const std::string& array_name: request.coverages_id)
+    descriptions.push_back(cache.get(descriptions_document_key + ":" + array_name,
+                                     [&array_name]() { return make_coverage_description(array_name); }));
+
+  envelope = cache.get(descriptions_document_key, &make_descriptions_envelope);
+}
+
 eows::ogc::wcs::operations::describe_coverage::describe_coverage(const describe_coverage_request& req)
   : eows::ogc::wcs::core::operation(),
     pimpl_(new eows::ogc::wcs::operations::describe_coverage::impl(req))
@@ -67,6 +104,44 @@ eows::ogc::wcs::operations::describe_coverage::~describe_coverage()
 }
 
 void eows::ogc::wcs::operations::describe_coverage::execute()
+{
+  pimpl_->load();
+
+  const std::string& envelope = pimpl_->envelope->body;
+
+  const std::size_t marker_pos = envelope.find(descriptions_marker);
+
+  assert(marker_pos != std::string::npos);
+
+  std::size_t size = envelope.size();
+
+  for(const eows::ogc::wcs::core::document_ptr& description: pimpl_->descriptions)
+    size += description->body.size();
+
+  pimpl_->xml_representation.clear();
+  pimpl_->xml_representation.reserve(size);
+  pimpl_->xml_representation.append(envelope, 0, marker_pos);
+
+  for(const eows::ogc::wcs::core::document_ptr& description: pimpl_->descriptions)
+    pimpl_->xml_representation.append(description->body);
+
+  pimpl_->xml_representation.append(envelope, marker_pos + descriptions_marker.size(), std::string::npos);
+}
+
+std::string eows::ogc::wcs::operations::describe_coverage::etag() const
+{
+  pimpl_->load();
+
+  // The document is made of cached pieces: its tag is derived from theirs
+  std::string tags = pimpl_->envelope->etag;
+
+  for(const eows::ogc::wcs::core::document_ptr& description: pimpl_->descriptions)
+    tags += description->etag;
+
+  return eows::ogc::wcs::core::document_cache::make_etag(tags);
+}
+
+static std::string make_descriptions_envelope()
 {
   rapidxml::xml_document<> xml_doc;
 
@@ -88,116 +163,128 @@ void eows::ogc::wcs::operations::describe_coverage::execute()
   wcs_document->append_attribute(xml_doc.allocate_attribute("xsi:schemaLocation"," http://www.opengis.net/wcs/2.0 http://schemas.opengis.net/wcs/2.0/wcsDescribeCoverage.xsd http://www.opengis.net/wcseo/1.0 https://geoservice.dlr.de/eoc/schemas/wcseo/1.0/wcsEOCoverage.xsd"));
   xml_doc.append_node(wcs_document);
 
-  for(const std::string& array_name: pimpl_->request.coverages_id)
-  {
-    try
-    {
-      // Retrived GeoArray metadata
-      const eows::geoarray::geoarray_t& array = geoarray::geoarray_manager::instance().get(array_name);
+  wcs_document->value(descriptions_marker.c_str(), descriptions_marker.size());
 
-      const eows::ogc::wcs::core::capabilities_t capabilities = manager::instance().capabilities();
+  std::string xml_representation;
 
-      rapidxml::xml_node<>* coverage = xml_doc.allocate_node(rapidxml::node_element, "wcs:CoverageDescription");
-      coverage->append_attribute(xml_doc.allocate_attribute("gml:id", array.name.c_str()));
+  rapidxml::print(std::back_inserter(xml_representation), xml_doc, 0);
 
-      // Preparing Bounds
-      eows::ogc::wcs::core::make_coverage_bounded_by(&xml_doc, coverage, array, array.spatial_extent, array.dimensions.t);
+  return xml_representation;
+}
 
-      // Preparing metadata/Timedomain
+static std::string make_coverage_description(const std::string& array_name)
+{
+  rapidxml::xml_document<> xml_doc;
+
+  try
+  {
+    // Retrived GeoArray metadata
+    const std::shared_ptr<const eows::geoarray::geoarray_t> array_ptr = eows::geoarray::geoarray_manager::instance().get(array_name);
+    const eows::geoarray::geoarray_t& array = *array_ptr;
+
+    rapidxml::xml_node<>* coverage = xml_doc.allocate_node(rapidxml::node_element, "wcs:CoverageDescription");
+    coverage->append_attribute(xml_doc.allocate_attribute("gml:id", array.name.c_str()));
+
+    // Preparing Bounds
+    eows::ogc::wcs::core::make_coverage_bounded_by(&xml_doc, coverage, array, array.spatial_extent, array.dimensions.t);
+
+    // Preparing metadata/Timedomain
+    {
+      rapidxml::xml_node<>* metadata = xml_doc.allocate_node(rapidxml::node_element, "gmlcov:metadata");
+      coverage->append_node(metadata);
       {
-        rapidxml::xml_node<>* metadata = xml_doc.allocate_node(rapidxml::node_element, "gmlcov:metadata");
-        coverage->append_node(metadata);
-        {
-          rapidxml::xml_node<>* extension = xml_doc.allocate_node(rapidxml::node_element, "gmlcov:Extension");
-          metadata->append_node(extension);
+        rapidxml::xml_node<>* extension = xml_doc.allocate_node(rapidxml::node_element, "gmlcov:Extension");
+        metadata->append_node(extension);
 
-          rapidxml::xml_node<>*timedomain = xml_doc.allocate_node(rapidxml::node_element, "wcsgs:TimeDomain");
+        rapidxml::xml_node<>*timedomain = xml_doc.allocate_node(rapidxml::node_element, "wcsgs:TimeDomain");
 
-          const std::vector<std::string>& timeline = array.timeline.time_points();
-          // Setting default timeposition as last tiff
-          timedomain->append_attribute(xml_doc.allocate_attribute("default", timeline[timeline.size() - 1].c_str()));
-          extension->append_node(timedomain);
+        const std::vector<std::string>& timeline = array.timeline.time_points();
+        // Setting default timeposition as last tiff
+        timedomain->append_attribute(xml_doc.allocate_attribute("default", timeline[timeline.size() - 1].c_str()));
+        extension->append_node(timedomain);
 
-          for(auto& time: timeline)
-          {
-            rapidxml::xml_node<>* time_instant = xml_doc.allocate_node(rapidxml::node_element, "gml:TimeInstant");
-            timedomain->append_node(time_instant);
-            const std::string time_id_name = array.name + "_td_" + std::to_string(array.timeline.index(time));
-            time_instant->append_attribute(xml_doc.allocate_attribute("gml:id", xml_doc.allocate_string(time_id_name.c_str())));
-            time_instant->append_node(xml_doc.allocate_node(rapidxml::node_element, "gml:timePosition", xml_doc.allocate_string(time.c_str())));
-          }
+        for(auto& time: timeline)
+        {
+          rapidxml::xml_node<>* time_instant = xml_doc.allocate_node(rapidxml::node_element, "gml:TimeInstant");
+          timedomain->append_node(time_instant);
+          const std::string time_id_name = array.name + "_td_" + std::to_string(array.timeline.index(time));
+          time_instant->append_attribute(xml_doc.allocate_attribute("gml:id", xml_doc.allocate_string(time_id_name.c_str())));
+          time_instant->append_node(xml_doc.allocate_node(rapidxml::node_element, "gml:timePosition", xml_doc.allocate_string(time.c_str())));
         }
       }
+    }
 
-      // Preparing CoverageID
-      {
-        rapidxml::xml_node<>* coverage_id = xml_doc.allocate_node(rapidxml::node_element,
-                                                                  "wcs:CoverageId",
-                                                                  array.name.c_str());
-        coverage->append_node(coverage_id);
-      }
-      // Preparing domainSet
+    // Preparing CoverageID
+    {
+      rapidxml::xml_node<>* coverage_id = xml_doc.allocate_node(rapidxml::node_element,
+                                                                "wcs:CoverageId",
+                                                                array.name.c_str());
+      coverage->append_node(coverage_id);
+    }
+    // Preparing domainSet
+    {
+      rapidxml::xml_node<>* domain_set = xml_doc.allocate_node(rapidxml::node_element, "gml:domainSet");
+      coverage->append_node(domain_set);
       {
-        rapidxml::xml_node<>* domain_set = xml_doc.allocate_node(rapidxml::node_element, "gml:domainSet");
-        coverage->append_node(domain_set);
+        rapidxml::xml_node<>* grid = xml_doc.allocate_node(rapidxml::node_element, "gml:Grid");
+        grid->append_attribute(xml_doc.allocate_attribute("gml:id", array.name.c_str()));
+        grid->append_attribute(xml_doc.allocate_attribute("dimension", "2"));
+        domain_set->append_node(grid);
         {
-          rapidxml::xml_node<>* grid = xml_doc.allocate_node(rapidxml::node_element, "gml:Grid");
-          grid->append_attribute(xml_doc.allocate_attribute("gml:id", array.name.c_str()));
-          grid->append_attribute(xml_doc.allocate_attribute("dimension", "2"));
-          domain_set->append_node(grid);
-          {
-            rapidxml::xml_node<>* limits = xml_doc.allocate_node(rapidxml::node_element, "gml:limits");
-            grid->append_node(limits);
+          rapidxml::xml_node<>* limits = xml_doc.allocate_node(rapidxml::node_element, "gml:limits");
+          grid->append_node(limits);
 
-            {
-              rapidxml::xml_node<>* grid_envelope = xml_doc.allocate_node(rapidxml::node_element, "gml:GridEnvelope");
-              limits->append_node(grid_envelope);
-
-              std::string low = (std::to_string(array.dimensions.x.min_idx) + " ") +
-                                (std::to_string(array.dimensions.y.min_idx));
-              rapidxml::xml_node<>* elm = xml_doc.allocate_node(rapidxml::node_element,
-                                                                "gml:low",
-                                                                xml_doc.allocate_string(low.c_str()));
-
-              std::string high = (std::to_string(array.dimensions.x.max_idx) + " " +
-                                  std::to_string(array.dimensions.y.max_idx));
-
-              grid_envelope->append_node(elm);
-              elm = xml_doc.allocate_node(rapidxml::node_element,
-                                          "gml:high",
-                                          xml_doc.allocate_string(high.c_str()));
-              grid_envelope->append_node(elm);
-            }
+          {
+            rapidxml::xml_node<>* grid_envelope = xml_doc.allocate_node(rapidxml::node_element, "gml:GridEnvelope");
+            limits->append_node(grid_envelope);
+
+            std::string low = (std::to_string(array.dimensions.x.min_idx) + " ") +
+                              (std::to_string(array.dimensions.y.min_idx));
+            rapidxml::xml_node<>* elm = xml_doc.allocate_node(rapidxml::node_element,
+                                                              "gml:low",
+                                                              xml_doc.allocate_string(low.c_str()));
+
+            std::string high = (std::to_string(array.dimensions.x.max_idx) + " " +
+                                std::to_string(array.dimensions.y.max_idx));
+
+            grid_envelope->append_node(elm);
+            elm = xml_doc.allocate_node(rapidxml::node_element,
+                                        "gml:high",
+                                        xml_doc.allocate_string(high.c_str()));
+            grid_envelope->append_node(elm);
+          }
 
-            std::string axis_labels = array.dimensions.x.name + " " + array.dimensions.y.name;
+          std::string axis_labels = array.dimensions.x.name + " " + array.dimensions.y.name;
 
-            limits->append_node(xml_doc.allocate_node(rapidxml::node_element, "gml:axisLabels", xml_doc.allocate_string(axis_labels.c_str())));
-          }
+          limits->append_node(xml_doc.allocate_node(rapidxml::node_element, "gml:axisLabels", xml_doc.allocate_string(axis_labels.c_str())));
         }
       }
-      // Preparing RangeSet
-      eows::ogc::wcs::core::make_coverage_range_type(&xml_doc, coverage, array.attributes);
-
-      // Preparing Service Parameters
-      {
-        rapidxml::xml_node<>* parameters = xml_doc.allocate_node(rapidxml::node_element, "wcs:ServiceParameters");
-        coverage->append_node(parameters);
-        // TODO: Is it dynamically?
-        parameters->append_node(xml_doc.allocate_node(rapidxml::node_element, "wcs:CoverageSubtype", "GridCoverage"));
-        parameters->append_node(xml_doc.allocate_node(rapidxml::node_element, "wcs:nativeFormat", "image/tiff"));
-      }
-
-      // Appending CoverageDescription into WCS document
-      wcs_document->append_node(coverage);
     }
-    catch(const std::invalid_argument& e)
+    // Preparing RangeSet
+    eows::ogc::wcs::core::make_coverage_range_type(&xml_doc, coverage, array.attributes);
+
+    // Preparing Service Parameters
     {
-      EOWS_LOG_DEBUG(e.what());
-      throw invalid_parameter_error(e.what(), "CoverageNotFound");
+      rapidxml::xml_node<>* parameters = xml_doc.allocate_node(rapidxml::node_element, "wcs:ServiceParameters");
+      coverage->append_node(parameters);
+      // TODO: Is it dynamically?
+      parameters->append_node(xml_doc.allocate_node(rapidxml::node_element, "wcs:CoverageSubtype", "GridCoverage"));
+      parameters->append_node(xml_doc.allocate_node(rapidxml::node_element, "wcs:nativeFormat", "image/tiff"));
     }
+
+    xml_doc.append_node(coverage);
+  }
+  catch(const std::invalid_argument& e)
+  {
+    EOWS_LOG_DEBUG(e.what());
+    throw eows::ogc::invalid_parameter_error(e.what(), "CoverageNotFound");
   }
 
-  rapidxml::print(std::back_inserter(pimpl_->xml_representation), xml_doc, 0);
+  std::string xml_representation;
+
+  rapidxml::print(std::back_inserter(xml_representation), xml_doc, 0);
+
+  return xml_representation;
 }
 
 const char*eows::ogc::wcs::operations::describe_coverage::content_type() const
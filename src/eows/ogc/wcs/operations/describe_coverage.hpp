@@ -67,6 +67,11 @@ namespace eows
              * @return
              */
             const std::string& to_string() const override;
+
+            /**
+             * @brief Retrieves the entity tag of the requested coverage descriptions
+             */
+            std::string etag() const override;
           private:
             struct impl;
             impl* pimpl_;
@@ -30,6 +30,7 @@
 #include "../core/data_types.hpp"
 #include "data_types.hpp"
 #include "../manager.hpp"
+#include "../core/document_cache.hpp"
 #include "../core/utils.hpp"
 // EOWS OGC ows module (provider)
 #include "../../ows/data_types.hpp"
@@ -50,11 +51,20 @@ struct eows::ogc::wcs::operations::get_capabilities::impl
 
   }
 
+  //! It retrieves the cached GetCapabilities document, building it on first use
+  const eows::ogc::wcs::core::document_ptr& get_document();
+
   eows::ogc::wcs::operations::get_capabilities_request request;
-  std::string xml_representation;
+  eows::ogc::wcs::core::document_ptr document;
   std::string format;
 };
 
+//! Key of the GetCapabilities document in the WCS document cache
+static const std::string capabilities_document_key("GetCapabilities");
+
+//! It serializes the WCS capabilities and the coverage summaries
+static std::string make_capabilities_document();
+
 eows::ogc::wcs::operations::get_capabilities::get_capabilities(const get_capabilities_request& req)
   : eows::ogc::wcs::core::operation(),
     pimpl_(new eows::ogc::wcs::operations::get_capabilities::impl(req))
@@ -67,9 +77,37 @@ eows::ogc::wcs::operations::get_capabilities::~get_capabilities()
   delete pimpl_;
 }
 
+const eows::ogc::wcs::core::document_ptr& eows::ogc::wcs::operations::get_capabilities::impl::get_document()
+{
+  if (document == nullptr)
+    document = eows::ogc::wcs::core::document_cache::instance().get(capabilities_document_key, &make_capabilities_document);
+
+  return document;
+}
+
 void eows::ogc::wcs::operations::get_capabilities::execute()
 {
-  const eows::ogc::wcs::core::capabilities_t capabilities = manager::instance().capabilities();
+  pimpl_->get_document();
+}
+
+const char*eows::ogc::wcs::operations::get_capabilities::content_type() const
+{
+  return pimpl_->format.c_str();
+}
+
+const std::string& eows::ogc::wcs::operations::get_capabilities::to_string() const
+{
+  return pimpl_->get_document()->body;
+}
+
+std::string eows::ogc::wcs::operations::get_capabilities::etag() const
+{
+  return pimpl_->get_document()->etag;
+}
+
+static std::string make_capabilities_document()
+{
+  const eows::ogc::wcs::core::capabilities_t& capabilities = eows::ogc::wcs::manager::instance().capabilities();
 
   rapidxml::xml_document<> xml_doc;
 
@@ -180,11 +218,12 @@ void eows::ogc::wcs::operations::get_capabilities::execute()
   // Contents
   // ========
   child = xml_doc.allocate_node(rapidxml::node_element, "wcs:Contents");
-  std::vector<std::string> geoarrays = geoarray::geoarray_manager::instance().list_arrays();
+  std::vector<std::string> geoarrays = eows::geoarray::geoarray_manager::instance().list_arrays();
 
   for(const std::string& array_name: geoarrays)
   {
-    const geoarray::geoarray_t& array = geoarray::geoarray_manager::instance().get(array_name);
+    const std::shared_ptr<const eows::geoarray::geoarray_t> array_ptr = eows::geoarray::geoarray_manager::instance().get(array_name);
+    const eows::geoarray::geoarray_t& array = *array_ptr;
 
     sub_child = xml_doc.allocate_node(rapidxml::node_element, "wcs:CoverageSummary");
     {
@@ -201,15 +240,9 @@ void eows::ogc::wcs::operations::get_capabilities::execute()
   }
   wcs_document->append_node(child);
 
-  rapidxml::print(std::back_inserter(pimpl_->xml_representation), xml_doc, 0);
-}
+  std::string xml_representation;
 
-const char*eows::ogc::wcs::operations::get_capabilities::content_type() const
-{
-  return pimpl_->format.c_str();
-}
+  rapidxml::print(std::back_inserter(xml_representation), xml_doc, 0);
 
-const std::string& eows::ogc::wcs::operations::get_capabilities::to_string() const
-{
-  return pimpl_->xml_representation;
+  return xml_representation;
 }
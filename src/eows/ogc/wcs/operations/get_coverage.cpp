@@ -28,11 +28,14 @@
 // EOWS
 #include "get_coverage.hpp"
 #include "data_types.hpp"
+#include "../core/admission.hpp"
 #include "../core/utils.hpp"
+#include "../core/tuple_list_encoder.hpp"
 
 // EOWS Core
+#include "../../../core/bounded_queue.hpp"
 #include "../../../core/utils.hpp"
-#include "../../../core/file_remover.hpp"
+#include "../../../core/single_flight.hpp"
 #include "../../../core/logger.hpp"
 
 // EOWS GeoArray
@@ -44,8 +47,9 @@
 #include "../../../scidb/exception.hpp"
 #include "../../../scidb/connection.hpp"
 #include "../../../scidb/connection_pool.hpp"
-#include "../../../scidb/cell_iterator.hpp"
+#include "../../../scidb/chunk_iterator.hpp"
 #include "../../../scidb/scoped_query.hpp"
+#include "../../../scidb/utils.hpp"
 
 // EOWS Proj4
 #include "../../../proj4/converter.hpp"
@@ -58,8 +62,17 @@
 // GDAL
 #include <gdal_priv.h>
 
+// Boost
+#include <boost/lexical_cast.hpp>
+
 // STL
-#include <fstream>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <exception>
+#include <memory>
+#include <thread>
+#include <vector>
 
 // RapidXML
 #include <rapidxml/rapidxml.hpp>
@@ -76,20 +89,49 @@
 struct eows::ogc::wcs::operations::get_coverage::impl
 {
   impl(const eows::ogc::wcs::operations::get_coverage_request& req)
-    : request(req), file_handler(new eows::core::file_remover), output()
+    : request(req), array(nullptr), scale_x(1), scale_y(1), output()
   {
   }
 
+  /*!
+   * \brief It validates the client request against the geo array and builds the SciDB AFL query.
+   *
+   * \throws std::invalid_argument When the coverage does not exist
+   * \throws eows::ogc::ogc_error When the subsets or attributes are not valid for the coverage
+   */
+  void prepare();
+
+  /*!
+   * \brief It estimates the size of the response from the prepared dimensions and attributes datatypes.
+   * \return Expected response size, in bytes
+   */
+  std::size_t estimate_size() const;
+
   /*!
    * \brief It generates a SciDB Query AFL to retrieve GetCoverage
-   * \param array - Current geoarray
-   * \param dimensions - Client subsets dimensions
+   * \param array_name - SciDB array: the geo array or one of its pyramid levels
+   * \param dimensions - Client subsets dimensions, in array_name cells
    * \param attributes - Client rangesubset attributes
+   * \param regrid_x - Number of array_name cells along X averaged in an output cell
+   * \param regrid_y - Number of array_name cells along Y averaged in an output cell
    * \return A SciDB AFL query
    */
-  std::string generate_afl(const eows::geoarray::geoarray_t& array,
+  std::string generate_afl(const std::string& array_name,
                            const std::vector<eows::geoarray::dimension_t> dimensions,
-                           const std::vector<geoarray::attribute_t>& attributes);
+                           const std::vector<geoarray::attribute_t>& attributes,
+                           const int64_t regrid_x = 1,
+                           const int64_t regrid_y = 1);
+
+  /*!
+   * \brief It computes the downscaling factors of WCS Scaling extension parameters.
+   *
+   * \throws eows::ogc::invalid_parameter_error When an axis is unknown or the time axis is scaled
+   *
+   * \param array - Current geoarray
+   * \param factor_x - Number of cells along X in an output cell
+   * \param factor_y - Number of cells along Y in an output cell
+   */
+  void retrieve_scaling(const eows::geoarray::geoarray_t& array, int64_t& factor_x, int64_t& factor_y) const;
 
   /*!
    * \brief It performs subset reprojection if client gives a SRID different from Geoarray native. After that, it checks
@@ -124,27 +166,49 @@ struct eows::ogc::wcs::operations::get_coverage::impl
   /*!
    * \brief It reads a SciDB query result as GML document. Once read, it prepares a WCS Coverage XML element with meta result
    * \param array - Current Geo Array
-   * \param cell_it - SciDB Query Result
+   * \param chunk_it - SciDB Query Result
    * \param used_extent - Array extent used for retrieving SciDB data
    * \param dimensions_query - Dimensions used to fetch query
    * \param attributes_query - Client Attributes used to fetch query
    */
   void process_as_document(const eows::geoarray::geoarray_t& array,
-                           boost::shared_ptr<eows::scidb::cell_iterator> cell_it,
+                           boost::shared_ptr<eows::scidb::chunk_iterator> chunk_it,
                            const eows::geoarray::spatial_extent_t& used_extent,
                            const std::vector<geoarray::dimension_t> dimensions_query,
                            const std::vector<geoarray::attribute_t>& attributes_query);
 
+  /*!
+   * \brief It prints the GML document without the cells of gml:tupleList.
+   * \param envelope - Printed document
+   * \return Position in envelope where the cells must be written
+   */
+  std::size_t print_envelope(const eows::geoarray::geoarray_t& array,
+                             const eows::geoarray::spatial_extent_t& used_extent,
+                             const std::vector<geoarray::dimension_t>& dimensions_query,
+                             const std::vector<geoarray::attribute_t>& attributes_query,
+                             std::string& envelope);
+
+  /*!
+   * \brief It writes the prepared query result as GML document piece by piece, while it is fetched.
+   *
+   * A thread fetches the SciDB chunks and another one encodes them, linked by bounded
+   * queues, while the calling thread hands the encoded pieces to write. At most a few
+   * chunks are held in memory, whatever the size of the coverage.
+   *
+   * \param write - Output callback
+   */
+  void stream_as_document(const eows::ogc::wcs::core::operation::writer_t& write);
+
   /*!
    * \brief It prepares Query result as GeoTIFF image.
    *
    * \throws eows::ogc::wcs::no_such_field_error When an attribute value is not supported by eows
    *
-   * \param cell_it SciDB array query result
+   * \param chunk_it SciDB array query result
    * \param array Geo array
    * \param dimensions An ordered dimensions used to Query(X, Y, T ...)
    */
-  void process_as_tiff(boost::shared_ptr<eows::scidb::cell_iterator> cell_it,
+  void process_as_tiff(boost::shared_ptr<eows::scidb::chunk_iterator> chunk_it,
                        const eows::geoarray::geoarray_t& array,
                        const std::vector<eows::geoarray::dimension_t> dimensions,
                        const geoarray::spatial_extent_t& used_extent,
@@ -152,13 +216,160 @@ struct eows::ogc::wcs::operations::get_coverage::impl
 
   //!< Represents WCS client arguments given. TODO: Use it as smart-pointer instead a const value
   const eows::ogc::wcs::operations::get_coverage_request request;
-  //!< Represents Auto File remover for Image generation
-  eows::core::file_remover_ptr file_handler;
+  //!< Requested geo array
+  std::shared_ptr<const eows::geoarray::geoarray_t> array;  //!< Kept alive while the request runs
+  //!< Array extent used for retrieving SciDB data
+  eows::geoarray::spatial_extent_t used_extent;
+  //!< Dimensions used to query, in order (X, Y, T)
+  std::vector<eows::geoarray::dimension_t> dimensions;
+  //!< Attributes used to query
+  std::vector<eows::geoarray::attribute_t> attributes;
+  //!< Downscaling factors along X and Y. Dimensions are given in downscaled cells
+  int64_t scale_x;
+  int64_t scale_y;
+  //!< SciDB AFL query
+  std::string query;
   //!< Represents WCS GetCoverage output in GML format.
   std::string output;
+  //!< Represents the output shared among identical requests
+  std::shared_ptr<const std::string> result;
 };
 
-void eows::ogc::wcs::operations::get_coverage::impl::process_as_tiff(boost::shared_ptr<eows::scidb::cell_iterator> cell_it,
+//! Coalesces identical GetCoverage requests running at the same time
+static eows::core::single_flight<std::string> coverage_flights;
+
+//! Reprojection settings of the service, except the target CRS
+static eows::gdal::warp_options warp_defaults;
+
+//! Number of chunks waiting in each stage of a streamed GetCoverage
+static const std::size_t stream_queue_size = 4;
+
+// Delimiters used in GML generation
+static const std::string row_delimiter(",");
+static const std::string attr_delimiter(" ");
+
+//! Placeholder printed in gml:tupleList and replaced by the encoded cells
+static const std::string tuple_list_marker("@EOWS_TUPLE_LIST@");
+
+//! Builds the tupleList encoder for the attributes of a query result
+static eows::ogc::wcs::core::tuple_list_encoder make_encoder(const eows::scidb::chunk_iterator& chunk_it,
+                                                             const std::vector<eows::geoarray::attribute_t>& attributes)
+{
+  std::vector<std::size_t> attributes_pos;
+  std::vector<int> datatypes;
+
+  for(const eows::geoarray::attribute_t& attribute: attributes)
+  {
+    attributes_pos.push_back(chunk_it.attribute_pos(attribute.name));
+    datatypes.push_back(attribute.datatype);
+  }
+
+  return eows::ogc::wcs::core::tuple_list_encoder(attributes_pos, datatypes, row_delimiter[0], attr_delimiter[0]);
+}
+
+//! Rethrows the exception being handled as the error reported to WCS clients
+static void rethrow_as_ogc_error(const std::string& coverage_id)
+{
+  try
+  {
+    throw;
+  }
+  // known module error
+  catch(const eows::ogc::ogc_error&)
+  {
+    throw;
+  }
+  catch(const eows::gdal::gdal_error& e)
+  {
+    throw eows::ogc::ogc_error(e.what(), "UnappliedCode");
+  }
+  // thirdparty errors
+  catch(const eows::scidb::connection_open_error& e)
+  {
+    // Todo: Throw UnappliedError
+    throw eows::ogc::ogc_error(e.what(), "");
+  }
+  // STL errors
+  catch(const std::invalid_argument& e) //thrown by geoarray::manager.get() when array not found
+  {
+    throw eows::ogc::wcs::no_such_coverage_error("No such coverage '" + coverage_id + "'");
+  }
+}
+
+//! Describes the GeoTIFF options that change the encoded image
+static std::string geotiff_options_key(const eows::gdal::creation_options& options)
+{
+  return options.compression + "," + std::to_string(options.predictor) + "," +
+         (options.tiled ? std::to_string(options.block_width) + "x" + std::to_string(options.block_height) : "strip") + "," +
+         options.interleave + "," + (options.cog ? "cog" : "");
+}
+
+/*!
+  \brief Writes the values of a chunk column into the band windows covered by the chunk
+
+  The chunk cells are scattered into a buffer with the size of the chunk window,
+  clipped to the requested subset, with one slice per date. Each slice is written
+  at once into the band of its date: bands are ordered by date, then by attribute.
+
+  Values are transferred to GDAL as B, for column types that GDAL can not handle.
+ */
+template<class T, class B = T>
+static void write_chunk_column(eows::gdal::raster& file,
+                               const eows::scidb::chunk_block_t& block,
+                               const std::size_t attr_pos,
+                               const std::size_t attr_index,
+                               const std::size_t num_attributes,
+                               const std::vector<eows::geoarray::dimension_t>& dimensions)
+{
+  if(block.ncells == 0)
+    return;
+
+  const eows::geoarray::dimension_t& dimension_x = dimensions[0];
+  const eows::geoarray::dimension_t& dimension_y = dimensions[1];
+  const eows::geoarray::dimension_t& dimension_t = dimensions[2];
+
+  const bool has_time = block.first.size() > 2;
+
+  const int64_t xmin = std::max<int64_t>(block.first[0], dimension_x.min_idx);
+  const int64_t xmax = std::min<int64_t>(block.last[0], dimension_x.max_idx);
+  const int64_t ymin = std::max<int64_t>(block.first[1], dimension_y.min_idx);
+  const int64_t ymax = std::min<int64_t>(block.last[1], dimension_y.max_idx);
+  const int64_t tmin = has_time ? std::max<int64_t>(block.first[2], dimension_t.min_idx) : dimension_t.min_idx;
+  const int64_t tmax = has_time ? std::min<int64_t>(block.last[2], dimension_t.max_idx) : dimension_t.min_idx;
+
+  if((xmin > xmax) || (ymin > ymax) || (tmin > tmax))
+    return;
+
+  const std::size_t width = static_cast<std::size_t>(xmax - xmin + 1);
+  const std::size_t height = static_cast<std::size_t>(ymax - ymin + 1);
+  const std::size_t ntimes = static_cast<std::size_t>(tmax - tmin + 1);
+  const std::size_t slice_size = width * height;
+
+  std::vector<B> window(slice_size * ntimes, B());
+
+  const T* values = block.columns[attr_pos].values<T>();
+
+  for(std::size_t i = 0; i != block.ncells; ++i)
+  {
+    const int64_t col = block.position(i, 0) - xmin;
+    const int64_t row = block.position(i, 1) - ymin;
+    const int64_t slice = has_time ? block.position(i, 2) - tmin : 0;
+
+    window[slice * slice_size + row * width + col] = static_cast<B>(values[i]);
+  }
+
+  for(std::size_t slice = 0; slice != ntimes; ++slice)
+  {
+    const std::size_t band_id = (static_cast<std::size_t>(tmin - dimension_t.min_idx) + slice) * num_attributes + attr_index;
+
+    file.write(band_id,
+               static_cast<std::size_t>(xmin - dimension_x.min_idx),
+               static_cast<std::size_t>(ymin - dimension_y.min_idx),
+               width, height, window.data() + slice * slice_size);
+  }
+}
+
+void eows::ogc::wcs::operations::get_coverage::impl::process_as_tiff(boost::shared_ptr<eows::scidb::chunk_iterator> chunk_it,
                                                                      const eows::geoarray::geoarray_t& array,
                                                                      const std::vector<eows::geoarray::dimension_t> dimensions,
                                                                      const eows::geoarray::spatial_extent_t& used_extent,
@@ -166,86 +377,136 @@ void eows::ogc::wcs::operations::get_coverage::impl::process_as_tiff(boost::shar
 {
   const eows::geoarray::dimension_t& dimension_x = dimensions[0];
   const eows::geoarray::dimension_t& dimension_y = dimensions[1];
+  const eows::geoarray::dimension_t& dimension_t = dimensions[2];
   // Computing Image Limits
   const int x = dimension_x.max_idx - dimension_x.min_idx + 1;
   const int y = dimension_y.max_idx - dimension_y.min_idx + 1;
-
-  const std::string tmp_file_path = eows::core::generate_unique_path(".tiff");
+  const std::size_t ntimes = static_cast<std::size_t>(dimension_t.max_idx - dimension_t.min_idx + 1);
 
   // TODO: Get array limits (from scidb query or input parameters?)
   eows::gdal::raster file;
 
-  std::vector<eows::gdal::property> properties;
+  const std::size_t attributes_size = used_attributes.size();
+
+  std::vector<std::size_t> attributes_pos;
 
   for(const eows::geoarray::attribute_t& attribute: used_attributes)
-    properties.push_back(eows::gdal::property(cell_it->attribute_pos(attribute.name),
-                                              attribute.datatype));
+    attributes_pos.push_back(chunk_it->attribute_pos(attribute.name));
 
-  // Creating dataset
-  file.create(tmp_file_path, x, y, properties);
+  // One band per date and attribute, ordered by date
+  std::vector<eows::gdal::property> properties;
 
-  const std::size_t attributes_size = used_attributes.size();
+  for(std::size_t t = 0; t < ntimes; ++t)
+    for(std::size_t index = 0; index < attributes_size; ++index)
+      properties.push_back(eows::gdal::property(attributes_pos[index], used_attributes[index].datatype));
+
+  // Reprojecting to the outputCrs when the dataset is closed
+  eows::gdal::warp_options warp;
+
+  const bool reproject = (request.output_crs != 0) && (request.output_crs != array.i_meta.srid);
+
+  if (reproject)
+  {
+    warp = warp_defaults;
+    warp.target_wkt = eows::proj4::srs_manager::instance().get(request.output_crs).wkt;
 
-  // fill
-  while(!cell_it->end())
+    if (!request.interpolation.empty())
+      warp.resampling = request.interpolation;
+  }
+
+  // Creating dataset in memory, with client layout and compression
+  file.create_in_memory(x, y, properties, request.geotiff, warp);
+
+  // Cells out of the coverage are filled with the missing value of their attribute
+  if (reproject)
+  {
+    for(std::size_t t = 0; t < ntimes; ++t)
+      for(std::size_t index = 0; index < attributes_size; ++index)
+        file.get_band(t * attributes_size + index)->set_no_data(used_attributes[index].missing_value);
+  }
+
+  // Naming bands as attribute and date when there is more than one date
+  if (ntimes > 1)
+  {
+    for(std::size_t t = 0; t < ntimes; ++t)
+    {
+      const std::string& date = array.timeline.get(static_cast<std::size_t>(dimension_t.min_idx - array.dimensions.t.min_idx) + t);
+
+      for(std::size_t index = 0; index < attributes_size; ++index)
+        file.get_band(t * attributes_size + index)->set_description(used_attributes[index].name + "_" + date);
+    }
+  }
+
+  // fill, a whole chunk window at a time
+  while(!chunk_it->end())
   {
-    const ::scidb::Coordinate& x = cell_it->get_position()[0] - dimension_x.min_idx;
-    const ::scidb::Coordinate& y = cell_it->get_position()[1] - dimension_y.min_idx;
+    const eows::scidb::chunk_block_t& block = chunk_it->get_block();
 
     for(std::size_t index = 0; index < attributes_size; ++index)
     {
-      eows::gdal::band* band = file.get_band(index);
       const eows::geoarray::attribute_t& attribute = used_attributes[index];
+      const std::size_t attr_pos = attributes_pos[index];
 
       if (attribute.datatype == eows::geoarray::datatype_t::int8_dt)
-        band->set_value(x, y, cell_it->get_int8(attribute.name));
+        write_chunk_column<int8_t>(file, block, attr_pos, index, attributes_size, dimensions);
       else if (attribute.datatype == eows::geoarray::datatype_t::uint8_dt)
-        band->set_value(x, y, cell_it->get_uint8(attribute.name));
+        write_chunk_column<uint8_t>(file, block, attr_pos, index, attributes_size, dimensions);
       else if (attribute.datatype == eows::geoarray::datatype_t::int16_dt)
-        band->set_value(x, y, cell_it->get_int16(attribute.name));
+        write_chunk_column<int16_t>(file, block, attr_pos, index, attributes_size, dimensions);
       else if (attribute.datatype == eows::geoarray::datatype_t::uint16_dt)
-        band->set_value(x, y, cell_it->get_uint16(attribute.name));
+        write_chunk_column<uint16_t>(file, block, attr_pos, index, attributes_size, dimensions);
       else if (attribute.datatype == eows::geoarray::datatype_t::int32_dt)
-        band->set_value(x, y, cell_it->get_int32(attribute.name));
-      else // TODO
+        write_chunk_column<int32_t>(file, block, attr_pos, index, attributes_size, dimensions);
+      else if (attribute.datatype == eows::geoarray::datatype_t::uint32_dt)
+        write_chunk_column<uint32_t>(file, block, attr_pos, index, attributes_size, dimensions);
+      else if (attribute.datatype == eows::geoarray::datatype_t::int64_dt)
+        write_chunk_column<int64_t, double>(file, block, attr_pos, index, attributes_size, dimensions);
+      else if (attribute.datatype == eows::geoarray::datatype_t::uint64_dt)
+        write_chunk_column<uint64_t, double>(file, block, attr_pos, index, attributes_size, dimensions);
+      else if (attribute.datatype == eows::geoarray::datatype_t::float_dt)
+        write_chunk_column<float>(file, block, attr_pos, index, attributes_size, dimensions);
+      else if (attribute.datatype == eows::geoarray::datatype_t::double_dt)
+        write_chunk_column<double>(file, block, attr_pos, index, attributes_size, dimensions);
+      else
         throw eows::ogc::wcs::no_such_field_error("Invalid attribute type, got " + eows::geoarray::datatype_t::to_string(attribute.datatype));
     }
 
-    cell_it->next();
+    chunk_it->next();
   }
 
   // Setting TIFF metadata
   file.set_name(array.name);
   file.set_description(array.description);
-  file.set_metadata(gdal::raster::metadata::x_resolution, std::to_string(array.spatial_resolution.x));
-  file.set_metadata(gdal::raster::metadata::y_resolution, std::to_string(array.spatial_resolution.y));
-
-  // Array gtransform
-  file.transform(used_extent.xmin,
-                 used_extent.ymin,
-                 used_extent.xmax,
-                 used_extent.ymax,
-                 array.spatial_resolution.x,
-                 array.spatial_resolution.y);
+  file.set_metadata(gdal::raster::metadata::x_resolution, std::to_string(array.i_meta.spatial_resolution.x * scale_x));
+  file.set_metadata(gdal::raster::metadata::y_resolution, std::to_string(array.i_meta.spatial_resolution.y * scale_y));
+
+  // Array gtransform. Output cells are aligned to the array origin, so the image starts at the first output cell,
+  // not at the requested extent. Cells are placed like in eows::geoarray::grid, in the internal array grid and SRS
+  const double resolution_x = array.i_meta.spatial_resolution.x * scale_x;
+  const double resolution_y = array.i_meta.spatial_resolution.y * scale_y;
+
+  const double origin_x = array.i_meta.spatial_extent.xmin + static_cast<double>(dimension_x.min_idx - array.dimensions.x.min_idx) * resolution_x;
+  const double origin_y = array.i_meta.spatial_extent.ymax - static_cast<double>(dimension_y.min_idx - array.dimensions.y.min_idx) * resolution_y;
+
+  file.transform(origin_x,
+                 origin_y,
+                 origin_x + x * resolution_x,
+                 origin_y - y * resolution_y,
+                 resolution_x,
+                 resolution_y);
   // Retrieving Projection. CHECK: It may throw exception when not found.
-  const eows::proj4::srs_description_t& proj = eows::proj4::srs_manager::instance().get(array.srid);
+  const eows::proj4::srs_description_t& proj = eows::proj4::srs_manager::instance().get(array.i_meta.srid);
   // Setting Projection
   file.set_projection(proj.wkt);
-  // Adding to File remover
-  file_handler->add(tmp_file_path);
-  // Close dataset
-  file.close();
-  // Opening generated image
-  std::ifstream stream(tmp_file_path, std::ios::binary);
-  // Reading Image binary to string
-  output = std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
-  // Closing file
-  stream.close();
+  // Closing dataset and moving the encoded image to output
+  file.close(output);
 }
 
-std::string eows::ogc::wcs::operations::get_coverage::impl::generate_afl(const eows::geoarray::geoarray_t& array,
+std::string eows::ogc::wcs::operations::get_coverage::impl::generate_afl(const std::string& array_name,
                                                                          const std::vector<eows::geoarray::dimension_t> dimensions,
-                                                                         const std::vector<eows::geoarray::attribute_t>& attributes)
+                                                                         const std::vector<eows::geoarray::attribute_t>& attributes,
+                                                                         const int64_t regrid_x,
+                                                                         const int64_t regrid_y)
 {
   // Defining helpers for AFL Query generation
   std::string min_values;
@@ -261,7 +522,7 @@ std::string eows::ogc::wcs::operations::get_coverage::impl::generate_afl(const e
   max_values.pop_back();
 
   // Generating SciDB AFL statement
-  std::string query_str = "between(" + array.name + ", "
+  std::string query_str = "between(" + array_name + ", "
                                      + min_values + ", "
                                      + max_values + ")";
 
@@ -277,9 +538,85 @@ std::string eows::ogc::wcs::operations::get_coverage::impl::generate_afl(const e
 
   query_str = "project(" + query_str + ", " + attributes_afl + ")";
 
+  if (regrid_x == 1 && regrid_y == 1)
+    return query_str;
+
+  // Averaging blocks of cells. Missing values are turned into nulls, so that avg skips them,
+  // and the averages are casted back to the attribute datatypes, with the missing value for blocks without data
+  std::string valid_afl;
+  std::string valid_attributes_afl;
+  std::string aggregates_afl;
+  std::string casts_afl;
+
+  for(auto& attribute: attributes)
+  {
+    const std::string type_name = eows::geoarray::datatype_t::to_string(attribute.datatype);
+    const std::string missing_value = boost::lexical_cast<std::string>(attribute.missing_value);
+    const std::string avg_name = attribute.name + "_avg";
+    const std::string valid_name = attribute.name + "_valid";
+
+    valid_afl += ", " + valid_name + ", iif(" + attribute.name + " = " + missing_value + ", null, " + attribute.name + ")";
+    valid_attributes_afl += valid_name + ",";
+    aggregates_afl += ", avg(" + valid_name + ") as " + avg_name;
+    casts_afl += ", " + attribute.name + ", iif(is_null(" + avg_name + "), " + type_name + "(" + missing_value + "), " + type_name + "(" + avg_name + "))";
+  }
+
+  valid_attributes_afl.pop_back();
+
+  query_str = "project(apply(" + query_str + valid_afl + "), " + valid_attributes_afl + ")";
+
+  query_str = "regrid(" + query_str + ", " + std::to_string(regrid_x) + ", " + std::to_string(regrid_y) + ", 1" + aggregates_afl + ")";
+
+  query_str = "project(apply(" + query_str + casts_afl + "), " + attributes_afl + ")";
+
   return query_str;
 }
 
+void eows::ogc::wcs::operations::get_coverage::impl::retrieve_scaling(const eows::geoarray::geoarray_t& array,
+                                                                      int64_t& factor_x,
+                                                                      int64_t& factor_y) const
+{
+  const eows::ogc::wcs::core::scaling_t& scaling = request.scaling;
+
+  double fx = scaling.factor;
+  double fy = scaling.factor;
+
+  for(const auto& axis: scaling.axes)
+  {
+    if (axis.first == array.dimensions.x.alias)
+      fx = axis.second;
+    else if (axis.first == array.dimensions.y.alias)
+      fy = axis.second;
+    else if (axis.first == array.dimensions.t.alias)
+    {
+      if (axis.second != 1.0)
+        throw eows::ogc::invalid_parameter_error("Time axis can not be scaled", "InvalidScaleFactor");
+    }
+    else
+      throw eows::ogc::invalid_parameter_error("No axis found. " + axis.first, "ScaleAxisUndefined");
+  }
+
+  // Rounding factors to whole cells
+  factor_x = std::max<int64_t>(1, std::llround(fx));
+  factor_y = std::max<int64_t>(1, std::llround(fy));
+
+  for(const auto& axis: scaling.sizes)
+  {
+    // Taking the smallest factor whose output is not larger than the requested size
+    if (axis.first == array.dimensions.x.alias)
+      factor_x = (dimensions[0].size() + axis.second - 1) / axis.second;
+    else if (axis.first == array.dimensions.y.alias)
+      factor_y = (dimensions[1].size() + axis.second - 1) / axis.second;
+    else if (axis.first == array.dimensions.t.alias)
+    {
+      if (axis.second != dimensions[2].size())
+        throw eows::ogc::invalid_parameter_error("Time axis can not be scaled", "InvalidExtent");
+    }
+    else
+      throw eows::ogc::invalid_parameter_error("No axis found. " + axis.first, "ScaleAxisUndefined");
+  }
+}
+
 void eows::ogc::wcs::operations::get_coverage::impl::validate(const std::size_t& srid,
                                                               const eows::geoarray::spatial_extent_t& extent,
                                                               double& latitude,
@@ -353,29 +690,44 @@ eows::ogc::wcs::operations::get_coverage::impl::retrieve_subsets(const eows::geo
       // Time ID
       else if(client_subset.name == grid_array.geo_array->dimensions.t.alias)
       {
-        try
-        {
-          eows::geoarray::dimension_t time_dimension;
-          time_dimension.name = client_subset.name;
-          int64_t min = grid_array.geo_array->timeline.index(client_subset.min);
-          int64_t max;
-//          if (client_subset.max == wcs::core::subset_t::no_value)
-//            max = grid_array.geo_array->dimensions.t.max_idx;
-//          else
-            max = grid_array.geo_array->timeline.index(client_subset.min);
-
-          if (min < grid_array.geo_array->dimensions.t.min_idx ||
-              max > grid_array.geo_array->dimensions.t.max_idx)
-            throw eows::ogc::wcs::invalid_axis_error("Time axis does not intersects. " + client_subset.name);
+        const eows::geoarray::dimension_t& array_time = grid_array.geo_array->dimensions.t;
+        const eows::geoarray::timeline_t& timeline = grid_array.geo_array->timeline;
 
-          time_dimension.min_idx = min;
-          time_dimension.max_idx = max;
-          output[2] = time_dimension;
+        eows::geoarray::dimension_t time_dimension = array_time;
+
+        if (client_subset.max == wcs::core::subset_t::no_value)
+        {
+          // Slicing: the time point must exist
+          try
+          {
+            time_dimension.min_idx = timeline.index(client_subset.min);
+            time_dimension.max_idx = time_dimension.min_idx;
+          }
+          catch(const std::out_of_range& err)
+          {
+            throw eows::ogc::wcs::invalid_axis_error(std::string("Invalid time range ") + err.what());
+          }
         }
-        catch(const std::out_of_range& err)
+        else
         {
-          throw eows::ogc::wcs::invalid_axis_error(std::string("Invalid time range ") + err.what());
+          // Trimming: takes the time points inside the interval. ISO 8601 dates sort as strings
+          const std::vector<std::string>& time_points = timeline.time_points();
+
+          auto first = std::lower_bound(time_points.begin(), time_points.end(), client_subset.min);
+          auto last = std::upper_bound(time_points.begin(), time_points.end(), client_subset.max);
+
+          if (first >= last)
+            throw eows::ogc::wcs::invalid_axis_error("Time axis does not intersects. " + client_subset.name);
+
+          time_dimension.min_idx = array_time.min_idx + (first - time_points.begin());
+          time_dimension.max_idx = array_time.min_idx + (last - time_points.begin()) - 1;
         }
+
+        if (time_dimension.min_idx < array_time.min_idx ||
+            time_dimension.max_idx > array_time.max_idx)
+          throw eows::ogc::wcs::invalid_axis_error("Time axis does not intersects. " + client_subset.name);
+
+        output[2] = time_dimension;
       }
       else
         throw eows::ogc::wcs::invalid_axis_error("No axis found. " + client_subset.name);
@@ -397,50 +749,12 @@ eows::ogc::wcs::operations::get_coverage::impl::retrieve_subsets(const eows::geo
   return output;
 }
 
-void eows::ogc::wcs::operations::get_coverage::impl::process_as_document(const eows::geoarray::geoarray_t& array,
-                                                                         boost::shared_ptr<eows::scidb::cell_iterator> cell_it,
-                                                                         const eows::geoarray::spatial_extent_t& used_extent,
-                                                                         const std::vector<eows::geoarray::dimension_t> dimensions_query,
-                                                                         const std::vector<eows::geoarray::attribute_t>& attributes_query)
+std::size_t eows::ogc::wcs::operations::get_coverage::impl::print_envelope(const eows::geoarray::geoarray_t& array,
+                                                                           const eows::geoarray::spatial_extent_t& used_extent,
+                                                                           const std::vector<eows::geoarray::dimension_t>& dimensions_query,
+                                                                           const std::vector<eows::geoarray::attribute_t>& attributes_query,
+                                                                           std::string& envelope)
 {
-  // Defining output stream where SciDB will be stored (GML format)
-  std::ostringstream ss;
-  // Retrieving Array size
-  auto attributes_size = attributes_query.size();
-  // Delimiter used in GML generation
-  const std::string row_delimiter(",");
-  const std::string attr_delimiter(" ");
-  /*
-    It will generate SciDB data output in GML syntax.
-    Note: You may change delimiters as you need, but remember to update GML output.
-
-    data0_attr1 data0_attr2 data0_attrN,dataN_attr1 dataN_attr2 dataN_attrN,...
-  */
-  while(!cell_it->end())
-  {
-    for(std::size_t attr_pos = 0; attr_pos < attributes_size; ++attr_pos)
-    {
-      const eows::geoarray::attribute_t& attribute = attributes_query[attr_pos];
-
-      if (attribute.datatype == eows::geoarray::datatype_t::int16_dt)
-        ss << cell_it->get_int16(attribute.name);
-      else if (attribute.datatype == eows::geoarray::datatype_t::uint16_dt)
-        ss << cell_it->get_uint16(attribute.name);
-      else if (attribute.datatype == eows::geoarray::datatype_t::uint8_dt)
-        ss << cell_it->get_uint8(attribute.name);
-      else if (attribute.datatype == eows::geoarray::datatype_t::int8_dt)
-        ss << std::to_string(cell_it->get_int8(attribute.name));
-      else if (attribute.datatype == eows::geoarray::datatype_t::int32_dt)
-        ss << cell_it->get_int32(attribute.name);
-
-      // TODO: Remove this check. It should append and remove last char on finish attr
-      if (attr_pos + 1 < attributes_size)
-        ss << attr_delimiter;
-    }
-    ss << row_delimiter;
-    cell_it->next();
-  }
-
   // Defining GetCoverage XML document
   rapidxml::xml_document<> xml_doc;
 
@@ -472,9 +786,7 @@ void eows::ogc::wcs::operations::get_coverage::impl::process_as_document(const e
   wcs_document->append_node(range_set);
   rapidxml::xml_node<>* data_block = xml_doc.allocate_node(rapidxml::node_element, "gml:DataBlock");
 
-  const std::string scidb_data = ss.str();
-
-  rapidxml::xml_node<>* tuple_list = xml_doc.allocate_node(rapidxml::node_element, "gml:tupleList", scidb_data.c_str(), 0, scidb_data.size());
+  rapidxml::xml_node<>* tuple_list = xml_doc.allocate_node(rapidxml::node_element, "gml:tupleList", tuple_list_marker.c_str(), 0, tuple_list_marker.size());
   // Defining delimiter in order to client use to read properly row
   tuple_list->append_attribute(xml_doc.allocate_attribute("ts", row_delimiter.c_str()));
   // Defining delimiter for coverage attribute
@@ -486,7 +798,155 @@ void eows::ogc::wcs::operations::get_coverage::impl::process_as_document(const e
   // Preparing rangetype
   eows::ogc::wcs::core::make_coverage_range_type(&xml_doc, wcs_document, attributes_query);
 
-  rapidxml::print(std::back_inserter(output), xml_doc, 0);
+  // Printing only the envelope: the cells are written between its two halves
+  rapidxml::print(std::back_inserter(envelope), xml_doc, 0);
+
+  const std::size_t marker_pos = envelope.find(tuple_list_marker);
+
+  assert(marker_pos != std::string::npos);
+
+  envelope.erase(marker_pos, tuple_list_marker.size());
+
+  return marker_pos;
+}
+
+void eows::ogc::wcs::operations::get_coverage::impl::process_as_document(const eows::geoarray::geoarray_t& array,
+                                                                         boost::shared_ptr<eows::scidb::chunk_iterator> chunk_it,
+                                                                         const eows::geoarray::spatial_extent_t& used_extent,
+                                                                         const std::vector<eows::geoarray::dimension_t> dimensions_query,
+                                                                         const std::vector<eows::geoarray::attribute_t>& attributes_query)
+{
+  std::string envelope;
+
+  const std::size_t marker_pos = print_envelope(array, used_extent, dimensions_query, attributes_query, envelope);
+
+  /*
+    It will generate SciDB data output in GML syntax.
+    Note: You may change delimiters as you need, but remember to update GML output.
+
+    data0_attr1 data0_attr2 data0_attrN,dataN_attr1 dataN_attr2 dataN_attrN,...
+  */
+  const eows::ogc::wcs::core::tuple_list_encoder encoder = make_encoder(*chunk_it, attributes_query);
+
+  std::size_t ncells = 1;
+
+  for(const eows::geoarray::dimension_t& dimension: dimensions_query)
+    ncells *= static_cast<std::size_t>(dimension.max_idx - dimension.min_idx + 1);
+
+  output.clear();
+  output.reserve(envelope.size() + encoder.estimate(ncells));
+  output.append(envelope, 0, marker_pos);
+
+  encoder.encode(*chunk_it, output);
+
+  output.append(envelope, marker_pos, std::string::npos);
+}
+
+void eows::ogc::wcs::operations::get_coverage::impl::stream_as_document(const eows::ogc::wcs::core::operation::writer_t& write)
+{
+  // Open SciDB connection
+  eows::scidb::connection conn = eows::scidb::connection_pool::instance().get(array->cluster_id);
+
+  // Performing AFL query execution
+  boost::shared_ptr<::scidb::QueryResult> query_result = conn.execute(query);
+  // Wrapping SciDB result with Scoped query to auto complete query exec
+  eows::scidb::scoped_query sc(query_result, &conn);
+
+  if((query_result == nullptr) || (query_result->array == nullptr))
+    throw eows::scidb::query_execution_error("Error in SciDB query result");
+
+  eows::scidb::chunk_iterator chunk_it(query_result->array);
+
+  const eows::ogc::wcs::core::tuple_list_encoder encoder = make_encoder(chunk_it, attributes);
+
+  std::string envelope;
+
+  const std::size_t marker_pos = print_envelope(*array, used_extent, dimensions, attributes, envelope);
+
+  write(envelope.data(), marker_pos);
+
+  eows::core::bounded_queue<eows::scidb::chunk_block_t> blocks(stream_queue_size);
+  eows::core::bounded_queue<std::string> pieces(stream_queue_size);
+
+  std::exception_ptr fetch_error;
+  std::exception_ptr encode_error;
+
+  // Fetching: a copy of each chunk is handed over, so the iterator can move on
+  std::thread fetcher([&]()
+  {
+    try
+    {
+      for(; !chunk_it.end(); chunk_it.next())
+      {
+        eows::scidb::chunk_block_t block(chunk_it.get_block());
+
+        if(!blocks.push(std::move(block)))
+          break;
+      }
+    }
+    catch(...)
+    {
+      fetch_error = std::current_exception();
+    }
+
+    blocks.close();
+  });
+
+  // Encoding: one piece of text per chunk
+  std::thread encoding([&]()
+  {
+    try
+    {
+      eows::scidb::chunk_block_t block;
+
+      while(blocks.pop(block))
+      {
+        std::string piece;
+
+        encoder.encode(block, piece);
+
+        if(!piece.empty() && !pieces.push(std::move(piece)))
+          break;
+      }
+    }
+    catch(...)
+    {
+      encode_error = std::current_exception();
+    }
+
+    // Stops the fetcher too when giving up before the end
+    blocks.close();
+    pieces.close();
+  });
+
+  // Writing, in the calling thread
+  try
+  {
+    std::string piece;
+
+    while(pieces.pop(piece))
+      write(piece.data(), piece.size());
+  }
+  catch(...)
+  {
+    pieces.close();
+
+    encoding.join();
+    fetcher.join();
+
+    throw;
+  }
+
+  encoding.join();
+  fetcher.join();
+
+  if(fetch_error)
+    std::rethrow_exception(fetch_error);
+
+  if(encode_error)
+    std::rethrow_exception(encode_error);
+
+  write(envelope.data() + marker_pos, envelope.size() - marker_pos);
 }
 
 std::vector<eows::geoarray::attribute_t>
@@ -520,6 +980,110 @@ eows::ogc::wcs::operations::get_coverage::impl::retrieve_attributes(const eows::
     return array.attributes;
 }
 
+void eows::ogc::wcs::operations::get_coverage::impl::prepare()
+{
+  // Retrieve GeoArray information
+  array = geoarray::geoarray_manager::instance().get(request.coverage_id);
+
+  // Wrapping Geo Array as Grid type
+  eows::geoarray::grid grid_array(array.get());
+
+  // Retrieving spatial extent (Default array)
+  used_extent = array->spatial_extent;
+
+  // Array containing client limits sent in WCS request that will be used to build SciDB AFL query
+  dimensions = retrieve_subsets(grid_array, used_extent);
+
+  // Retrieve client attributes or array defaults
+  attributes = retrieve_attributes(*array);
+
+  // Reprojection is done by GDAL, while encoding the GeoTIFF
+  if ((request.output_crs != 0) && (request.output_crs != array->srid))
+  {
+    if (request.format != eows::core::IMAGE_TIFF)
+      throw eows::ogc::invalid_parameter_error("OutputCrs is only supported for image/tiff", "OutputCrs-NotSupported");
+
+    if (!eows::proj4::srs_manager::instance().exists(request.output_crs))
+      throw eows::ogc::invalid_parameter_error("OutputCrs 'EPSG:" + std::to_string(request.output_crs) + "' is not supported", "OutputCrs-NotSupported");
+  }
+
+  // Downscaling: reading the coarsest pyramid level whose cells tile the requested ones and averaging the rest with regrid
+  int64_t factor_x = 1;
+  int64_t factor_y = 1;
+
+  retrieve_scaling(*array, factor_x, factor_y);
+
+  std::string source = array->name;
+  int64_t level_factor = 1;
+
+  for(const eows::geoarray::pyramid_level_t& level: array->pyramid)
+  {
+    // Other levels would not align output cells with the base array ones: they fall back to the base array
+    if ((factor_x % level.factor == 0) && (factor_y % level.factor == 0))
+    {
+      source = level.name;
+      level_factor = level.factor;
+    }
+  }
+
+  const int64_t regrid_x = factor_x / level_factor;
+  const int64_t regrid_y = factor_y / level_factor;
+
+  scale_x = level_factor * regrid_x;
+  scale_y = level_factor * regrid_y;
+
+  // Maps an index range to cells of a given factor, which keep the first index
+  auto downscale = [](eows::geoarray::dimension_t& dimension, const int64_t first, const int64_t factor)
+  {
+    dimension.min_idx = first + (dimension.min_idx - first) / factor;
+    dimension.max_idx = first + (dimension.max_idx - first) / factor;
+  };
+
+  std::vector<eows::geoarray::dimension_t> source_dimensions = dimensions;
+
+  downscale(source_dimensions[0], array->dimensions.x.min_idx, level_factor);
+  downscale(source_dimensions[1], array->dimensions.y.min_idx, level_factor);
+
+  downscale(dimensions[0], array->dimensions.x.min_idx, scale_x);
+  downscale(dimensions[1], array->dimensions.y.min_idx, scale_y);
+
+  // Get Query AFL
+  query = generate_afl(source, source_dimensions, attributes, regrid_x, regrid_y);
+
+  EOWS_LOG_DEBUG(query);
+}
+
+std::size_t eows::ogc::wcs::operations::get_coverage::impl::estimate_size() const
+{
+  std::size_t ncells = 1;
+
+  for(const eows::geoarray::dimension_t& dimension: dimensions)
+    ncells *= dimension.size();
+
+  // GML text: the encoder estimate of the tupleList
+  if (request.format == eows::core::APPLICATION_XML)
+  {
+    std::vector<std::size_t> attributes_pos;
+    std::vector<int> datatypes;
+
+    for(const eows::geoarray::attribute_t& attribute: attributes)
+    {
+      attributes_pos.push_back(attributes_pos.size());
+      datatypes.push_back(attribute.datatype);
+    }
+
+    return eows::ogc::wcs::core::tuple_list_encoder(attributes_pos, datatypes).estimate(ncells);
+  }
+
+  // Images: the uncompressed pixels
+  std::size_t cell_size = 0;
+
+  for(const eows::geoarray::attribute_t& attribute: attributes)
+    cell_size += static_cast<std::size_t>(eows::geoarray::datatype_t::bytes(attribute.datatype));
+
+  return ncells * cell_size;
+}
+
 // GetCoverage Implementations
 
 eows::ogc::wcs::operations::get_coverage::get_coverage(const eows::ogc::wcs::operations::get_coverage_request& req)
@@ -537,79 +1101,90 @@ void eows::ogc::wcs::operations::get_coverage::execute()
 {
   try
   {
-    // Retrieve GeoArray information
-    const geoarray::geoarray_t& array = geoarray::geoarray_manager::instance().get(pimpl_->request.coverage_id);
+    pimpl_->prepare();
 
-    // Wrapping Geo Array as Grid type
-    eows::geoarray::grid grid_array(&array);
+    const geoarray::geoarray_t& array = *pimpl_->array;
 
-    // Retrieving spatial extent (Default array)
-    geoarray::spatial_extent_t used_extent = array.spatial_extent;
+    // Identical concurrent requests share a single query execution and its encoded output
+    std::string flight_key = std::string(eows::core::to_str(pimpl_->request.format)) + "|" + eows::scidb::normalize_afl(pimpl_->query);
 
-    // Array containing client limits sent in WCS request that will be used to build SciDB AFL query
-    std::vector<eows::geoarray::dimension_t> dimensions_to_query = pimpl_->retrieve_subsets(grid_array, used_extent);
+    // The GML envelope shows the requested extent, which differs between requests reading the same cells
+    if(pimpl_->request.format == eows::core::APPLICATION_XML)
+    {
+      const eows::geoarray::spatial_extent_t& extent = pimpl_->used_extent;
+
+      flight_key += "|" + boost::lexical_cast<std::string>(extent.xmin) + "," + boost::lexical_cast<std::string>(extent.ymin) + "," +
+                    boost::lexical_cast<std::string>(extent.xmax) + "," + boost::lexical_cast<std::string>(extent.ymax);
+    }
 
-    // Retrieve client attributes or array defaults
-    std::vector<eows::geoarray::attribute_t> attributes_to_query = pimpl_->retrieve_attributes(array);
+    if(pimpl_->request.format == eows::core::IMAGE_TIFF)
+      flight_key += "|" + geotiff_options_key(pimpl_->request.geotiff) + "|" +
+                    std::to_string(pimpl_->request.output_crs) + "," + pimpl_->request.interpolation;
 
-    // Get Query AFL
-    std::string query_str = pimpl_->generate_afl(array, dimensions_to_query, attributes_to_query);
+    pimpl_->result = coverage_flights.run(flight_key, [&]() -> std::shared_ptr<const std::string>
+    {
+      // Only the request running the query counts against the in-flight budget
+      eows::ogc::wcs::core::admission::ticket ticket = eows::ogc::wcs::core::admission::instance().admit(pimpl_->estimate_size());
 
-    EOWS_LOG_DEBUG(query_str);
+      // Open SciDB connection
+      eows::scidb::connection conn = eows::scidb::connection_pool::instance().get(array.cluster_id);
 
-    // Open SciDB connection
-    eows::scidb::connection conn = eows::scidb::connection_pool::instance().get(array.cluster_id);
+      // Performing AFL query execution
+      boost::shared_ptr<::scidb::QueryResult> query_result = conn.execute(pimpl_->query);
+      // Wrapping SciDB result with Scoped query to auto complete query exec
+      eows::scidb::scoped_query sc(query_result, &conn);
 
-    // Performing AFL query execution
-    boost::shared_ptr<::scidb::QueryResult> query_result = conn.execute(query_str);
-    // Wrapping SciDB result with Scoped query to auto complete query exec
-    eows::scidb::scoped_query sc(query_result, &conn);
+      // TODO: Improve err message when no data found or query error
+      if((query_result == nullptr) || (query_result->array == nullptr))
+        throw eows::scidb::query_execution_error("Error in SciDB query result");
 
-    // TODO: Improve err message when no data found or query error
-    if((query_result == nullptr) || (query_result->array == nullptr))
-      throw eows::scidb::query_execution_error("Error in SciDB query result");
+      boost::shared_ptr<eows::scidb::chunk_iterator> chunk_it(new eows::scidb::chunk_iterator(query_result->array));
+      /*
+        Defining how to build GetCoverage based in Format.
 
-    boost::shared_ptr<eows::scidb::cell_iterator> cell_it(new eows::scidb::cell_iterator(query_result->array));
-    /*
-      Defining how to build GetCoverage based in Format.
+        TODO: Create a factory handler
+      */
+      switch(pimpl_->request.format)
+      {
+        case eows::core::APPLICATION_XML:
+          pimpl_->process_as_document(array, std::move(chunk_it), pimpl_->used_extent, pimpl_->dimensions, pimpl_->attributes);
+          break;
+        case eows::core::IMAGE_TIFF:
+          pimpl_->process_as_tiff(std::move(chunk_it), array, pimpl_->dimensions, pimpl_->used_extent, pimpl_->attributes);
+          break;
+        default:
+          throw eows::ogc::not_implemented_error("Format not supported", "NotSupported");
+      }
 
-      TODO: Create a factory handler
-    */
-    switch(pimpl_->request.format)
-    {
-      case eows::core::APPLICATION_XML:
-        pimpl_->process_as_document(array, std::move(cell_it), used_extent, dimensions_to_query, attributes_to_query);
-        break;
-      case eows::core::IMAGE_TIFF:
-        pimpl_->process_as_tiff(std::move(cell_it), array, dimensions_to_query, used_extent, attributes_to_query);
-        break;
-      default:
-        throw eows::ogc::not_implemented_error("Format not supported", "NotSupported");
-    }
+      return std::make_shared<const std::string>(std::move(pimpl_->output));
+    });
   }
-  // known module error
-  catch(const eows::ogc::ogc_error&)
+  catch(...)
   {
-    throw;
+    rethrow_as_ogc_error(pimpl_->request.coverage_id);
   }
-  catch(const eows::gdal::gdal_error& e)
-  {
-    throw eows::ogc::ogc_error(e.what(), "UnappliedCode");
-  }
-  // thirdparty errors
-  catch(const eows::scidb::connection_open_error& e)
+}
+
+void eows::ogc::wcs::operations::get_coverage::stream(const writer_t& write)
+{
+  // A GeoTIFF is only known once the whole image is encoded: it is sent at once
+  if(pimpl_->request.format != eows::core::APPLICATION_XML)
   {
-    // Todo: Throw UnappliedError
-    throw eows::ogc::ogc_error(e.what(), "");
+    wcs::core::operation::stream(write);
+    return;
   }
-  // STL errors
-  catch(const std::invalid_argument& e) //thrown by geoarray::manager.get() when array not found
+
+  try
   {
-    throw wcs::no_such_coverage_error("No such coverage '" + pimpl_->request.coverage_id + "'");
+    pimpl_->prepare();
+
+    eows::ogc::wcs::core::admission::ticket ticket = eows::ogc::wcs::core::admission::instance().admit(pimpl_->estimate_size());
+
+    pimpl_->stream_as_document(write);
   }
-  catch(const std::exception& e)
+  catch(...)
   {
-    throw;
+    rethrow_as_ogc_error(pimpl_->request.coverage_id);
   }
 }
 
@@ -618,7 +1193,12 @@ const char*eows::ogc::wcs::operations::get_coverage::content_type() const
   return eows::core::to_str(pimpl_->request.format);
 }
 
+void eows::ogc::wcs::operations::get_coverage::set_warp_options(const eows::gdal::warp_options& options)
+{
+  warp_defaults = options;
+}
+
 const std::string& eows::ogc::wcs::operations::get_coverage::to_string() const
 {
-  return pimpl_->output;
+  return pimpl_->result ? *pimpl_->result : pimpl_->output;
 }
@@ -35,6 +35,12 @@
 
 namespace eows
 {
+  namespace gdal
+  {
+    // Forward declaration
+    struct warp_options;
+  }
+
   namespace ogc
   {
     namespace wcs
@@ -56,8 +62,25 @@ namespace eows
              * \throws eows::ogc::ogc_error -
              */
             void execute() override;
+
+            /*!
+             * \brief It performs a GetCoverage operation writing the GML document as the SciDB chunks arrive.
+             *
+             * Other formats are encoded as a whole and written at once.
+             *
+             * \throws eows::ogc::ogc_error -
+             */
+            void stream(const writer_t& write) override;
+
             const char* content_type() const override;
             const std::string& to_string() const override;
+
+            /*!
+             * \brief It sets how coverages are reprojected to the outputCrs: resampling, threads and chunk size.
+             *
+             * \note It must be called before serving requests.
+             */
+            static void set_warp_options(const eows::gdal::warp_options& options);
           private:
             struct impl;
             impl* pimpl_;
@@ -27,22 +27,177 @@
 
 // EOWS
 #include "wcs.hpp"
+#include "../../exception.hpp"
+#include "../../core/app_settings.hpp"
+#include "../../core/defines.hpp"
 #include "../../core/http_response.hpp"
 #include "../../core/http_request.hpp"
 #include "../../core/logger.hpp"
 #include "../../core/service_operations_manager.hpp"
 #include "../../core/utils.hpp"
+#include "../../geoarray/geoarray_manager.hpp"
+#include "exception.hpp"
 #include "manager.hpp"
+#include "core/admission.hpp"
+#include "core/document_cache.hpp"
 // WCS Operations
 #include "operations/factory.hpp"
 #include "operations/error_handler.hpp"
+#include "operations/get_coverage.hpp"
+// EOWS GDAL
+#include "../../gdal/data_types.hpp"
 // STL
 #include <memory>
 
+// Boost
+#include <boost/format.hpp>
+
+//! Default maximum expected size of a GetCoverage response
+static const std::size_t default_max_request_size = 512 * 1024 * 1024;
+
+//! Default maximum expected size of the GetCoverage responses being produced
+static const std::size_t default_max_in_flight_size = static_cast<std::size_t>(2048) * 1024 * 1024;
+
+//! Default time a GetCoverage waits for the in-flight budget, in milliseconds
+static const std::size_t default_queue_timeout = 10000;
+
+//! Reads an optional size of the wcs.admission configuration
+static void read_admission_size(const rapidjson::Value& jadmission, const char* key, std::size_t& value)
+{
+  rapidjson::Value::ConstMemberIterator jit = jadmission.FindMember(key);
+
+  if(jit == jadmission.MemberEnd())
+    return;
+
+  if(!jit->value.IsUint64())
+    throw eows::parse_error("Please check key 'wcs.admission." + std::string(key) + "' in file '" EOWS_CONFIG_FILE "'.");
+
+  value = static_cast<std::size_t>(jit->value.GetUint64());
+}
+
+static void initialize_admission()
+{
+  // Default limits are used if no configuration is given
+  std::size_t max_request_size = default_max_request_size;
+  std::size_t max_in_flight_size = default_max_in_flight_size;
+  std::size_t queue_timeout = default_queue_timeout;
+
+  const rapidjson::Document& doc = eows::core::app_settings::instance().get();
+
+  rapidjson::Value::ConstMemberIterator jwcs = doc.FindMember("wcs");
+
+  if(jwcs != doc.MemberEnd())
+  {
+    if(!jwcs->value.IsObject())
+      throw eows::parse_error("Key 'wcs' must be a valid JSON object in file '" EOWS_CONFIG_FILE "'.");
+
+    rapidjson::Value::ConstMemberIterator jadmission = jwcs->value.FindMember("admission");
+
+    if(jadmission != jwcs->value.MemberEnd())
+    {
+      if(!jadmission->value.IsObject())
+        throw eows::parse_error("Key 'wcs.admission' must be a valid JSON object in file '" EOWS_CONFIG_FILE "'.");
+
+      read_admission_size(jadmission->value, "max_request_size", max_request_size);
+      read_admission_size(jadmission->value, "max_in_flight_size", max_in_flight_size);
+      read_admission_size(jadmission->value, "queue_timeout", queue_timeout);
+    }
+  }
+
+  eows::ogc::wcs::core::admission::instance().configure(max_request_size, max_in_flight_size, queue_timeout);
+
+  boost::format msg("WCS admission: %1% bytes per request, %2% bytes in flight, %3% ms queue timeout.");
+
+  EOWS_LOG_INFO((msg % max_request_size % max_in_flight_size % queue_timeout).str());
+}
+
+//! Reads the optional reprojection settings of the wcs.warp configuration
+static void initialize_warp()
+{
+  // Chunks are warped by every core if no configuration is given
+  eows::gdal::warp_options options;
+  options.num_threads = "ALL_CPUS";
+
+  const rapidjson::Document& doc = eows::core::app_settings::instance().get();
+
+  rapidjson::Value::ConstMemberIterator jwcs = doc.FindMember("wcs");
+
+  if(jwcs != doc.MemberEnd() && jwcs->value.IsObject())
+  {
+    rapidjson::Value::ConstMemberIterator jwarp = jwcs->value.FindMember("warp");
+
+    if(jwarp != jwcs->value.MemberEnd())
+    {
+      if(!jwarp->value.IsObject())
+        throw eows::parse_error("Key 'wcs.warp' must be a valid JSON object in file '" EOWS_CONFIG_FILE "'.");
+
+      rapidjson::Value::ConstMemberIterator jit = jwarp->value.FindMember("resampling");
+
+      if(jit != jwarp->value.MemberEnd())
+      {
+        if(!jit->value.IsString())
+          throw eows::parse_error("Please check key 'wcs.warp.resampling' in file '" EOWS_CONFIG_FILE "'.");
+
+        options.resampling = jit->value.GetString();
+      }
+
+      jit = jwarp->value.FindMember("threads");
+
+      if(jit != jwarp->value.MemberEnd())
+      {
+        if(!jit->value.IsUint())
+          throw eows::parse_error("Please check key 'wcs.warp.threads' in file '" EOWS_CONFIG_FILE "'.");
+
+        // 0 warps in the calling thread
+        options.num_threads = jit->value.GetUint() == 0 ? std::string() : std::to_string(jit->value.GetUint());
+      }
+
+      jit = jwarp->value.FindMember("memory_limit");
+
+      if(jit != jwarp->value.MemberEnd())
+      {
+        if(!jit->value.IsUint64())
+          throw eows::parse_error("Please check key 'wcs.warp.memory_limit' in file '" EOWS_CONFIG_FILE "'.");
+
+        options.memory_limit = static_cast<double>(jit->value.GetUint64());
+      }
+    }
+  }
+
+  eows::ogc::wcs::operations::get_coverage::set_warp_options(options);
+
+  boost::format msg("WCS reprojection: '%1%' resampling, %2% threads.");
+
+  EOWS_LOG_INFO((msg % options.resampling % (options.num_threads.empty() ? std::string("1") : options.num_threads)).str());
+}
+
+//! It drops the cached documents describing a coverage whenever its metadata changes
+static void initialize_document_cache()
+{
+  eows::geoarray::geoarray_manager::instance().add_change_listener([](const std::string& name)
+  {
+    eows::ogc::wcs::core::document_cache& cache = eows::ogc::wcs::core::document_cache::instance();
+
+    cache.invalidate("DescribeCoverage:" + name);
+    cache.invalidate("GetCapabilities");
+  });
+}
+
+//! It tells if an If-None-Match header value matches an entity tag
+static bool etag_matches(const std::string& if_none_match, const std::string& etag)
+{
+  if(if_none_match == "*")
+    return true;
+
+  // A list of tags, possibly weak ones: W/"tag"
+  return if_none_match.find(etag) != std::string::npos;
+}
+
 //! It prepares a response output
-void make_response_error(eows::core::http_response& response, const std::string& error_msg, const std::string& content_type)
+void make_response_error(eows::core::http_response& response, const std::string& error_msg, const std::string& content_type,
+                         eows::core::http_response::status_t status = eows::core::http_response::bad_request)
 {
-  response.set_status(eows::core::http_response::bad_request);
+  response.set_status(status);
   response.add_header(eows::core::http_response::CONTENT_TYPE, content_type);
   response.add_header(eows::core::http_response::ACCESS_CONTROL_ALLOW_ORIGIN, "*");
   response.write(error_msg.c_str(), error_msg.size());
@@ -51,6 +206,9 @@ void make_response_error(eows::core::http_response& response, const std::string&
 void eows::ogc::wcs::handler::do_get(const eows::core::http_request& req,
                                      eows::core::http_response& res)
 {
+  // Once the first piece is sent, errors can no longer be reported as a WCS exception
+  bool streaming = false;
+
   try
   {
     // Putting every request parameters keys to lowercase
@@ -59,24 +217,72 @@ void eows::ogc::wcs::handler::do_get(const eows::core::http_request& req,
     // Retrieve WCS Operation
     std::unique_ptr<eows::ogc::wcs::core::operation> op(operations::build_operation(qstr));
 
-    // Executing Operation
-    op->execute();
+    // Cached documents are revalidated without being sent again
+    const std::string etag = op->etag();
+
+    if(!etag.empty() && etag_matches(eows::core::find_header(req, "If-None-Match"), etag))
+    {
+      res.set_status(eows::core::http_response::not_modified);
+      res.add_header("ETag", etag);
+      res.add_header(eows::core::http_response::ACCESS_CONTROL_ALLOW_ORIGIN, "*");
+      res.write("", 0);
+      return;
+    }
+
+    auto begin_stream = [&]()
+    {
+      res.set_status(eows::core::http_response::OK);
+      res.add_header(eows::core::http_response::CONTENT_TYPE, op->content_type());
+      res.add_header(eows::core::http_response::ACCESS_CONTROL_ALLOW_ORIGIN, "*");
+
+      if(!etag.empty())
+        res.add_header("ETag", etag);
+
+      res.begin_stream();
+
+      streaming = true;
+    };
+
+    // Executing Operation, sending the result as it is produced
+    op->stream([&](const char* data, std::size_t size)
+    {
+      if(!streaming)
+        begin_stream();
+
+      res.write_chunk(data, size);
+    });
 
-    // Retrieving Result
-    const std::string& output = op->to_string();
+    if(!streaming)
+      begin_stream();
 
-    res.set_status(eows::core::http_response::OK);
-    res.add_header(eows::core::http_response::CONTENT_TYPE, op->content_type());
-    res.add_header(eows::core::http_response::ACCESS_CONTROL_ALLOW_ORIGIN, "*");
-    res.write(output.c_str(), output.size());
+    res.end();
+  }
+  catch(const eows::ogc::wcs::server_busy_error& e)
+  {
+    // Admission happens before anything is sent: the client is asked to come back
+    res.add_header("Retry-After", "1");
+
+    make_response_error(res, operations::handle_error(e), "application/xml", eows::core::http_response::service_unavailable);
   }
   catch(const eows::ogc::ogc_error& e)
   {
+    if(streaming)
+    {
+      EOWS_LOG_ERROR(std::string("WCS response aborted: ") + e.what());
+      return;
+    }
+
     // Use WCS error handler
     make_response_error(res, operations::handle_error(e), "application/xml");
   }
   catch(const std::exception& e)
   {
+    if(streaming)
+    {
+      EOWS_LOG_ERROR(std::string("WCS response aborted: ") + e.what());
+      return;
+    }
+
     make_response_error(res, e.what(), "text/plain; charset=utf-8");
   }
 }
@@ -87,6 +293,12 @@ void eows::ogc::wcs::initialize()
 
   manager::instance().initialize();
 
+  initialize_admission();
+
+  initialize_warp();
+
+  initialize_document_cache();
+
   std::unique_ptr<handler> h(new handler);
   eows::core::service_operations_manager::instance().insert("/wcs", std::move(h));
 
@@ -43,6 +43,8 @@ class eows::scidb::cell_iterator::impl
 
     const ::scidb::Coordinates& get_position();
 
+    const ::scidb::Value& get_item(const std::size_t attr_pos) const;
+
     //std::string get_str(const std::size_t attr_pos) const;
 
     //std::string get_str(const std::string& attr_name) const;
@@ -123,6 +125,12 @@ eows::scidb::cell_iterator::get_position()
   return pimpl_->get_position();
 }
 
+const ::scidb::Value&
+eows::scidb::cell_iterator::get_item(const std::size_t attr_pos) const
+{
+  return pimpl_->get_item(attr_pos);
+}
+
 //std::string
 //eows::scidb::cell_iterator::get_str(const std::size_t attr_pos) const
 //{
@@ -219,11 +227,11 @@ eows::scidb::cell_iterator::get_int8(const std::string& attr_name) const
   return pimpl_->get_int8(attr_name);
 }
 
-//uint16_t
-//eows::scidb::cell_iterator::get_uint16(const std::size_t attr_pos) const
-//{
-//  return pimpl_->get_uint16(attr_pos);
-//}
+uint16_t
+eows::scidb::cell_iterator::get_uint16(const std::size_t attr_pos) const
+{
+  return pimpl_->get_uint16(attr_pos);
+}
 
 uint16_t
 eows::scidb::cell_iterator::get_uint16(const std::string& attr_name) const
@@ -337,6 +345,12 @@ eows::scidb::cell_iterator::impl::get_position()
   return chunks_iterators_[0]->getPosition();
 }
 
+inline const ::scidb::Value&
+eows::scidb::cell_iterator::impl::get_item(const std::size_t pos) const
+{
+  return chunks_iterators_[pos]->getItem();
+}
+
 //inline std::string
 //eows::scidb::cell_iterator::impl::get_str(const std::size_t attr_pos) const
 //{
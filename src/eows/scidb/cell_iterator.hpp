@@ -29,6 +29,7 @@
 #define __EOWS_SCIDB_CELL_ITERATOR_HPP__
 
 // STL
+#include <cstdint>
 #include <memory>
 #include <string>
 
@@ -57,6 +58,17 @@ namespace eows
         //!
         const ::scidb::Coordinates& get_position();
 
+        //! Returns the SciDB value for the attribute indicated by a given position.
+        const ::scidb::Value& get_item(const std::size_t attr_pos) const;
+
+        /*!
+          \brief Returns the value for the attribute indicated by a given position as a value of type T.
+
+          T must match the attribute datatype: int8_t, uint8_t, int16_t, uint16_t, int32_t, uint32_t,
+          int64_t, uint64_t, float or double.
+         */
+        template<class T> T get(const std::size_t attr_pos) const;
+
         //! Returns a string value for the attribute indicated by a given position.
         //std::string get_str(const std::size_t attr_pos) const;
 
@@ -154,6 +166,56 @@ namespace eows
     {
       return at_end_;
     }
+
+    template<> inline int8_t cell_iterator::get<int8_t>(const std::size_t attr_pos) const
+    {
+      return get_item(attr_pos).getInt8();
+    }
+
+    template<> inline uint8_t cell_iterator::get<uint8_t>(const std::size_t attr_pos) const
+    {
+      return get_item(attr_pos).getUint8();
+    }
+
+    template<> inline int16_t cell_iterator::get<int16_t>(const std::size_t attr_pos) const
+    {
+      return get_item(attr_pos).getInt16();
+    }
+
+    template<> inline uint16_t cell_iterator::get<uint16_t>(const std::size_t attr_pos) const
+    {
+      return get_item(attr_pos).getUint16();
+    }
+
+    template<> inline int32_t cell_iterator::get<int32_t>(const std::size_t attr_pos) const
+    {
+      return get_item(attr_pos).getInt32();
+    }
+
+    template<> inline uint32_t cell_iterator::get<uint32_t>(const std::size_t attr_pos) const
+    {
+      return get_item(attr_pos).getUint32();
+    }
+
+    template<> inline int64_t cell_iterator::get<int64_t>(const std::size_t attr_pos) const
+    {
+      return get_item(attr_pos).getInt64();
+    }
+
+    template<> inline uint64_t cell_iterator::get<uint64_t>(const std::size_t attr_pos) const
+    {
+      return get_item(attr_pos).getUint64();
+    }
+
+    template<> inline float cell_iterator::get<float>(const std::size_t attr_pos) const
+    {
+      return get_item(attr_pos).getFloat();
+    }
+
+    template<> inline double cell_iterator::get<double>(const std::size_t attr_pos) const
+    {
+      return get_item(attr_pos).getDouble();
+    }
     
   }  // end namespace scidb
 }   // end namespace eows
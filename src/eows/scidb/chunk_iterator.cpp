@@ -0,0 +1,237 @@
+/*
+  Copyright (C) 2017 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of Earth Observation Web Services (EOWS).
+
+  EOWS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 3 as
+  published by the Free Software Foundation.
+
+  EOWS is distributed  "AS-IS" in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY OF ANY KIND; without even the implied warranty
+  of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with EOWS. See LICENSE. If not, write to
+  e-sensing team at <esensing-team@dpi.inpe.br>.
+ */
+
+
+/*!
+  \file eows/scidb/chunk_iterator.cpp
+
+  \brief A chunk iterator that decodes each chunk of a multidimensional array into contiguous attribute columns.
+ */
+
+// EOWS
+#include "chunk_iterator.hpp"
+
+// STL
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+class eows::scidb::chunk_iterator::impl
+{
+  public:
+
+    impl(const std::shared_ptr< ::scidb::Array >& a, bool& at_end);
+
+    const chunk_block_t& get_block() const;
+
+    std::size_t attribute_pos(const std::string& name) const;
+
+    void next();
+
+  private:
+
+    void load();
+
+  private:
+
+    std::shared_ptr< ::scidb::Array > array_;
+    std::vector< std::shared_ptr< ::scidb::ConstArrayIterator > > attribute_iterators_;
+    std::vector<std::string> attr_names_;
+    chunk_block_t block_;
+    bool& at_end_;
+};
+
+eows::scidb::chunk_iterator::chunk_iterator(const std::shared_ptr< ::scidb::Array >& a)
+  : pimpl_(nullptr),
+    at_end_(false)
+{
+  pimpl_ = new impl(a, at_end_);
+}
+
+eows::scidb::chunk_iterator::~chunk_iterator()
+{
+  delete pimpl_;
+}
+
+const eows::scidb::chunk_block_t&
+eows::scidb::chunk_iterator::get_block() const
+{
+  return pimpl_->get_block();
+}
+
+std::size_t
+eows::scidb::chunk_iterator::attribute_pos(const std::string& name) const
+{
+  return pimpl_->attribute_pos(name);
+}
+
+void
+eows::scidb::chunk_iterator::next()
+{
+  pimpl_->next();
+}
+
+eows::scidb::chunk_iterator&
+eows::scidb::chunk_iterator::operator++()
+{
+  pimpl_->next();
+
+  return *this;
+}
+
+inline
+eows::scidb::chunk_iterator::impl::impl(const std::shared_ptr< ::scidb::Array >& a, bool& at_end)
+  : array_(a),
+    at_end_(at_end)
+{
+  const ::scidb::ArrayDesc& description = array_->getArrayDesc();
+
+  const ::scidb::Attributes& attrs = description.getAttributes(true);
+
+  for(const ::scidb::AttributeDesc& att_description : attrs)
+  {
+    attr_names_.push_back(att_description.getName());
+
+    std::shared_ptr< ::scidb::ConstArrayIterator > it = array_->getConstIterator(att_description.getId());
+
+    if(it->end())
+      at_end_ = true;
+
+    attribute_iterators_.push_back(it);
+
+    chunk_column_t column;
+    column.type = att_description.getType();
+    column.type_size = att_description.getSize();
+
+    block_.columns.push_back(column);
+  }
+
+  if(attribute_iterators_.empty())
+    at_end_ = true;
+
+  if(!at_end_)
+    load();
+}
+
+inline const eows::scidb::chunk_block_t&
+eows::scidb::chunk_iterator::impl::get_block() const
+{
+  return block_;
+}
+
+inline std::size_t
+eows::scidb::chunk_iterator::impl::attribute_pos(const std::string& name) const
+{
+  return std::find(attr_names_.begin(), attr_names_.end(), name) - attr_names_.begin();
+}
+
+inline void
+eows::scidb::chunk_iterator::impl::next()
+{
+  for(std::size_t i = 0; i != attribute_iterators_.size(); ++i)
+  {
+    ++(*attribute_iterators_[i]);
+
+    if(attribute_iterators_[i]->end())
+      at_end_ = true;
+  }
+
+  if(!at_end_)
+    load();
+}
+
+void
+eows::scidb::chunk_iterator::impl::load()
+{
+  const std::size_t num_attributes = attribute_iterators_.size();
+
+  for(std::size_t i = 0; i != num_attributes; ++i)
+  {
+    const ::scidb::ConstChunk& chunk = attribute_iterators_[i]->getChunk();
+
+    chunk_column_t& column = block_.columns[i];
+
+    const bool first_attribute = (i == 0);
+
+// all attributes share the same chunk box and cells: take them from the first one
+    if(first_attribute)
+    {
+      block_.first = chunk.getFirstPosition(false);
+      block_.last = chunk.getLastPosition(false);
+
+      const std::size_t ndims = block_.first.size();
+
+      block_.strides.assign(ndims, 1);
+
+      for(std::size_t d = ndims; d > 1; --d)
+        block_.strides[d - 2] = block_.strides[d - 1] * (block_.last[d - 1] - block_.first[d - 1] + 1);
+
+      block_.offsets.clear();
+      block_.offsets.reserve(chunk.count());
+    }
+
+    column.data.clear();
+    column.data.reserve(chunk.count() * column.type_size);
+
+    std::shared_ptr< ::scidb::ConstChunkIterator > cit = chunk.getConstIterator();
+
+    std::size_t ncells = 0;
+
+    bool dense = true;
+
+    for(; !cit->end(); ++(*cit), ++ncells)
+    {
+      const ::scidb::Value& v = cit->getItem();
+
+      column.data.resize(column.data.size() + column.type_size);
+
+      unsigned char* dst = column.data.data() + ncells * column.type_size;
+
+      if(v.isNull())
+        std::memset(dst, 0, column.type_size);
+      else
+        std::memcpy(dst, v.data(), std::min(column.type_size, v.size()));
+
+      if(!first_attribute)
+        continue;
+
+      const ::scidb::Coordinates& pos = cit->getPosition();
+
+      int64_t offset = 0;
+
+      for(std::size_t d = 0; d != pos.size(); ++d)
+        offset += (pos[d] - block_.first[d]) * block_.strides[d];
+
+      dense = dense && (offset == static_cast<int64_t>(ncells));
+
+      block_.offsets.push_back(offset);
+    }
+
+    if(first_attribute)
+    {
+      block_.ncells = ncells;
+
+// positions of dense chunks are implied by the cell index
+      if(dense)
+        block_.offsets.clear();
+    }
+
+    assert(ncells == block_.ncells);
+  }
+}
@@ -0,0 +1,140 @@
+/*
+  Copyright (C) 2017 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of Earth Observation Web Services (EOWS).
+
+  EOWS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 3 as
+  published by the Free Software Foundation.
+
+  EOWS is distributed  "AS-IS" in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY OF ANY KIND; without even the implied warranty
+  of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with EOWS. See LICENSE. If not, write to
+  e-sensing team at <esensing-team@dpi.inpe.br>.
+ */
+
+
+/*!
+  \file eows/scidb/chunk_iterator.hpp
+
+  \brief A chunk iterator that decodes each chunk of a multidimensional array into contiguous attribute columns.
+ */
+
+#ifndef __EOWS_SCIDB_CHUNK_ITERATOR_HPP__
+#define __EOWS_SCIDB_CHUNK_ITERATOR_HPP__
+
+// STL
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Boost
+#include <boost/noncopyable.hpp>
+
+// SciDB-API
+#include <SciDBAPI.h>
+
+namespace eows
+{
+  namespace scidb
+  {
+
+    //! The values of one attribute in a chunk, stored contiguously in the chunk iteration order.
+    struct chunk_column_t
+    {
+      ::scidb::TypeId type;             //!< SciDB datatype of the attribute.
+      std::size_t type_size;            //!< Number of bytes of each value.
+      std::vector<unsigned char> data;  //!< ncells * type_size bytes. Null cells are zero filled.
+
+      //! Returns the column values as an array of T. T must match the attribute datatype.
+      template<class T> const T* values() const
+      {
+        return reinterpret_cast<const T*>(data.data());
+      }
+    };
+
+    /*!
+      \brief The cells of a chunk, one contiguous column per attribute.
+
+      Cell positions are not materialized: the position of the i-th cell is
+      given by its row-major offset inside the chunk box [first, last], where
+      offset = sum((pos[d] - first[d]) * strides[d]). For dense chunks the offset
+      of the i-th cell is i itself.
+     */
+    struct chunk_block_t
+    {
+      ::scidb::Coordinates first;          //!< Position of the first cell of the chunk box (overlaps excluded).
+      ::scidb::Coordinates last;           //!< Position of the last cell of the chunk box (overlaps excluded).
+      std::vector<int64_t> strides;        //!< Row-major strides of the chunk box.
+      std::vector<int64_t> offsets;        //!< Offset of each cell in the box. Empty when the chunk is dense.
+      std::size_t ncells;                  //!< Number of non-empty cells in the chunk.
+      std::vector<chunk_column_t> columns; //!< One column per attribute, in the array attribute order.
+
+      //! Returns true if the i-th cell offset is i.
+      bool dense() const
+      {
+        return offsets.empty();
+      }
+
+      //! Returns the row-major offset of the i-th cell in the chunk box.
+      int64_t offset(const std::size_t i) const
+      {
+        return offsets.empty() ? static_cast<int64_t>(i) : offsets[i];
+      }
+
+      //! Returns the coordinate of the i-th cell along dimension d.
+      int64_t position(const std::size_t i, const std::size_t d) const
+      {
+        return first[d] + (offset(i) / strides[d]) % (last[d] - first[d] + 1);
+      }
+    };
+
+    //! A chunk iterator for a multidimensional array with several attributes.
+    class chunk_iterator : public boost::noncopyable
+    {
+      public:
+
+        //! Constructor.
+        chunk_iterator(const std::shared_ptr< ::scidb::Array >& a);
+
+        //! Destructor.
+        ~chunk_iterator();
+
+        //! Returns the cells of the current chunk.
+        const chunk_block_t& get_block() const;
+
+        //! Returns the attribute position for a named attribute.
+        std::size_t attribute_pos(const std::string& name) const;
+
+        //! Move iterator to the next chunk.
+        void next();
+
+        //! Returns true if iterator has finished traversing the array.
+        bool end() const;
+
+        //! Syntatic suggar operator.
+        chunk_iterator& operator++();
+
+      private:
+
+        class impl;
+
+        impl* pimpl_;
+
+        bool at_end_;
+    };
+
+    inline bool chunk_iterator::end() const
+    {
+      return at_end_;
+    }
+
+  }  // end namespace scidb
+}   // end namespace eows
+
+#endif  // __EOWS_SCIDB_CHUNK_ITERATOR_HPP__
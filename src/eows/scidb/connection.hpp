@@ -31,6 +31,7 @@
 // EOWS
 #include "connection_impl.hpp"
 #include "connection_pool.hpp"
+#include "../core/metrics.hpp"
 
 // STL
 #include <memory>
@@ -103,6 +104,8 @@ namespace eows
         boost::shared_ptr< ::scidb::QueryResult >
         execute(const std::string& query_str, const bool afl = true)
         {
+          eows::core::latency_timer timer(conn_->conn->query_duration());
+
           return conn_->conn->execute(query_str, afl);
         }
 
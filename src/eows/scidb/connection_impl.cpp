@@ -28,6 +28,7 @@
 // EOWS
 #include "connection_impl.hpp"
 #include "exception.hpp"
+#include "../core/metrics.hpp"
 
 // Boost
 #include <boost/format.hpp>
@@ -100,9 +101,14 @@ eows::scidb::connection_impl::close()
     ::scidb::SciDB& db_api = ::scidb::getSciDB();
 #endif
     
+// a handle that failed to disconnect can not be used anymore
+    void* handle = handle_;
+
+    handle_ = nullptr;
+
     try
     {
-      db_api.disconnect(handle_);
+      db_api.disconnect(handle);
     }
     catch(const ::scidb::Exception& e)
     {
@@ -112,8 +118,6 @@ eows::scidb::connection_impl::close()
     {
       throw connection_close_error("unknown error trying to close connection with coordinator server.");
     }
-    
-    handle_ = nullptr;
   }
 }
 
@@ -129,6 +133,26 @@ eows::scidb::connection_impl::is_closed() const
   return handle_ == nullptr;
 }
 
+bool
+eows::scidb::connection_impl::ping()
+{
+  if(handle_ == nullptr)
+    return false;
+
+  try
+  {
+    boost::shared_ptr< ::scidb::QueryResult > qresult = execute("list('instances')");
+
+    completed(qresult->queryID);
+  }
+  catch(...)
+  {
+    return false;
+  }
+
+  return true;
+}
+
 boost::shared_ptr<scidb::QueryResult>
 eows::scidb::connection_impl::execute(const std::string& query_str, const bool afl)
 {
@@ -171,7 +195,10 @@ eows::scidb::connection_impl::completed(::scidb::QueryID id)
 }
 
 eows::scidb::connection_impl::connection_impl(std::string cluster_id)
-  : handle_(nullptr), cluster_id_(cluster_id)
+  : handle_(nullptr), cluster_id_(cluster_id),
+    query_duration_(&eows::core::metrics_registry::instance().get_histogram("eows_scidb_query_duration_seconds",
+                                                                            "Time spent executing SciDB queries, by cluster.",
+                                                                            {{"cluster", cluster_id_}}))
 {
 }
 
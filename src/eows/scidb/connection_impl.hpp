@@ -41,6 +41,11 @@
 
 namespace eows
 {
+  namespace core
+  {
+    class histogram;
+  }
+
   namespace scidb
   {
 
@@ -75,6 +80,9 @@ namespace eows
 
         //! Returns true if the connection is closed.
         bool is_closed() const;
+
+        //! Returns true if the coordinator answers a lightweight catalog query through this connection.
+        bool ping();
       
         //! Executes a given query using AFL or AQL.
         /*!
@@ -84,6 +92,12 @@ namespace eows
         execute(const std::string& query_str, const bool afl = true);
 
         void completed(::scidb::QueryID id);
+
+        //! Time spent executing queries in the connection cluster.
+        eows::core::histogram& query_duration() const
+        {
+          return *query_duration_;
+        }
       
       protected:
 
@@ -100,6 +114,7 @@ namespace eows
       
         void* handle_;            //!< The real SciDB connection handle.
         std::string cluster_id_;  //!< The pool to which this connection belongs.
+        eows::core::histogram* query_duration_;  //!< Shared by the connections of the cluster.
     };
 
   }  // end namespace scidb
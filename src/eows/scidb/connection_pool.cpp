@@ -31,14 +31,20 @@
 #include "connection_impl.hpp"
 #include "data_types.hpp"
 #include "exception.hpp"
+#include "../core/logger.hpp"
+#include "../core/metrics.hpp"
 
 // STL
 #include <algorithm>
+#include <atomic>
 #include <cassert>
-#include <list>
+#include <chrono>
+#include <condition_variable>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 // Boost
@@ -46,97 +52,389 @@
 
 struct eows::scidb::connection_pool::impl
 {
-  // TODO: see how to fine tune mutex locking when acquiring connections!!
+  typedef std::chrono::steady_clock clock_type;
+
+  struct idle_connection
+  {
+    connection_impl* conn;
+    clock_type::time_point since;  // when the connection was returned to the pool
+  };
+
+// each cluster has its own lock and wait queue: acquiring a connection
+// from one cluster never blocks requests targeting another cluster
   struct pool
   {
     pool(const cluster_info_t& cinfo)
       : cluster_info(cinfo),
         num_connections(0),
-        available_connections(0)
+        next_check(clock_type::now() + std::chrono::seconds(cinfo.health_check_interval)),
+        wait_duration(eows::core::metrics_registry::instance().get_histogram("eows_scidb_pool_wait_seconds",
+                                                                             "Time spent getting a connection from the pool, by cluster.",
+                                                                             {{"cluster", cinfo.id}})),
+        in_use(eows::core::metrics_registry::instance().get_gauge("eows_scidb_pool_connections_in_use",
+                                                                  "Connections handed out by the pool, by cluster.",
+                                                                  {{"cluster", cinfo.id}})),
+        timeouts(eows::core::metrics_registry::instance().get_counter("eows_scidb_pool_timeouts_total",
+                                                                      "Requests that got no connection within the acquire timeout, by cluster.",
+                                                                      {{"cluster", cinfo.id}}))
     {
     }
     
     ~pool()
     {
-      assert(num_connections == available_connections);
-      assert(num_connections == connections.size());
+      assert(num_connections == idle.size());
       assert(num_connections <= cluster_info.max_connections);
       
 // release all connection in the pool
-      for(std::size_t i = 0; i != available_connections; ++i)
-      {
-        delete connections[i];
-      }
+      for(const idle_connection& ic : idle)
+        delete ic.conn;
     }
     
     cluster_info_t cluster_info;
-    std::vector<connection_impl*> connections; // note: it works like a stack that never shrink!
-    std::size_t num_connections;               // total number of connections in the pool
-    std::size_t available_connections;         // number of connections not used, i.e., available for use!
+    std::vector<idle_connection> idle;   // connections not in use: the most recently used at the back
+    std::size_t num_connections;         // physical connections, including the ones being opened or checked
+    clock_type::time_point next_check;   // only touched by the health checker thread
+    std::mutex mtx;
+    std::condition_variable available;   // signaled when a connection or a slot is released
+    eows::core::histogram& wait_duration;
+    eows::core::gauge& in_use;
+    eows::core::counter& timeouts;
   };
+
+  impl()
+    : sealed(false),
+      stop(false)
+  {
+  }
+
+// the registry is only written at startup: once a connection is requested
+// it is sealed and looked up without any lock
+  pool* find(const std::string& cluster_id);
+
+// opens connections until the pool has min_idle idle connections
+  void fill(pool& p);
+
+// evicts connections idle for too long and validates the remaining idle ones, reconnecting the broken ones
+  void check(pool& p);
+
+  void run_checker();
   
-  std::list<pool> pool_list;
-  std::mutex mtx;
+  std::map<std::string, std::unique_ptr<pool> > pools;
+  std::mutex mtx;                // guards pools until it is sealed
+  std::atomic<bool> sealed;      // no pool is added after the first request
+
+  std::thread checker;
+  std::mutex checker_mtx;
+  std::condition_variable checker_cv;
+  bool stop;
 };
 
+eows::scidb::connection_pool::impl::pool*
+eows::scidb::connection_pool::impl::find(const std::string& cluster_id)
+{
+  if(!sealed.load(std::memory_order_acquire))
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+
+    sealed.store(true, std::memory_order_release);
+  }
+
+  std::map<std::string, std::unique_ptr<pool> >::const_iterator it = pools.find(cluster_id);
+
+  return it == pools.end() ? nullptr : it->second.get();
+}
+
+void
+eows::scidb::connection_pool::impl::fill(pool& p)
+{
+  while(true)
+  {
+    {
+      std::lock_guard<std::mutex> lock(p.mtx);
+
+      if((p.idle.size() >= p.cluster_info.min_idle) ||
+         (p.num_connections >= p.cluster_info.max_connections))
+        return;
+
+      ++(p.num_connections);
+    }
+
+    std::unique_ptr<connection_impl> conn(new connection_impl(p.cluster_info.id));
+
+    try
+    {
+      conn->open(p.cluster_info.coordinator_address, p.cluster_info.coordinator_port);
+    }
+    catch(...)
+    {
+      {
+        std::lock_guard<std::mutex> lock(p.mtx);
+
+        --(p.num_connections);
+      }
+
+      p.available.notify_one();
+
+      throw;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(p.mtx);
+
+      p.idle.push_back(idle_connection{conn.release(), clock_type::now()});
+    }
+
+    p.available.notify_one();
+  }
+}
+
+void
+eows::scidb::connection_pool::impl::check(pool& p)
+{
+  std::vector<connection_impl*> evicted;
+  std::vector<connection_impl*> checking;
+
+  {
+    std::lock_guard<std::mutex> lock(p.mtx);
+
+    const clock_type::time_point now = clock_type::now();
+
+    std::size_t nevicted = 0;
+
+// the oldest idle connections are at the front
+    if(p.cluster_info.idle_timeout != 0)
+    {
+      const std::chrono::seconds idle_timeout(p.cluster_info.idle_timeout);
+
+      while((nevicted < p.idle.size()) &&
+            ((p.idle.size() - nevicted) > p.cluster_info.min_idle) &&
+            ((now - p.idle[nevicted].since) >= idle_timeout))
+      {
+        evicted.push_back(p.idle[nevicted].conn);
+        ++nevicted;
+      }
+    }
+
+    p.idle.erase(p.idle.begin(), p.idle.begin() + nevicted);
+
+    p.num_connections -= nevicted;
+
+// the remaining ones are validated later, one at a time
+    for(const idle_connection& ic : p.idle)
+      checking.push_back(ic.conn);
+  }
+
+  for(connection_impl* conn : evicted)
+    delete conn;
+
+  if(!evicted.empty())
+  {
+    boost::format log_msg("Closed %1% idle connection(s) of cluster '%2%'.");
+
+    EOWS_LOG_DEBUG((log_msg % evicted.size() % p.cluster_info.id).str());
+  }
+
+// take a single connection out of the pool at a time, so that requests
+// can still use the other ones while it is checked over the network
+  for(connection_impl* conn : checking)
+  {
+    clock_type::time_point since;
+
+    {
+      std::lock_guard<std::mutex> lock(p.mtx);
+
+      std::vector<idle_connection>::iterator it = std::find_if(p.idle.begin(), p.idle.end(),
+                                                               [conn](const idle_connection& ic) { return ic.conn == conn; });
+
+// it was handed out meanwhile: it is in use, so it will be checked next time
+      if(it == p.idle.end())
+        continue;
+
+      since = it->since;
+
+      p.idle.erase(it);
+    }
+
+    bool healthy = conn->ping();
+
+    if(!healthy)
+    {
+      try
+      {
+        conn->close();
+      }
+      catch(...)
+      {
+      }
+
+      try
+      {
+        conn->open(p.cluster_info.coordinator_address, p.cluster_info.coordinator_port);
+
+        healthy = true;
+      }
+      catch(const std::exception& e)
+      {
+        boost::format log_msg("Dropping broken connection of cluster '%1%': %2%");
+
+        EOWS_LOG_WARN((log_msg % p.cluster_info.id % e.what()).str());
+      }
+    }
+
+    bool keep = healthy;
+
+    {
+      std::lock_guard<std::mutex> lock(p.mtx);
+
+// connections released meanwhile may have filled the pool
+      keep = healthy && (p.idle.size() < p.cluster_info.max_idle);
+
+// keep the idle connections ordered by the time they were returned
+      if(keep)
+      {
+        std::vector<idle_connection>::iterator pos = std::upper_bound(p.idle.begin(), p.idle.end(), since,
+                                                                      [](const clock_type::time_point& t, const idle_connection& ic) { return t < ic.since; });
+
+        p.idle.insert(pos, idle_connection{conn, since});
+      }
+      else
+      {
+        --(p.num_connections);
+      }
+    }
+
+    if(!keep)
+      delete conn;
+
+    p.available.notify_one();
+  }
+
+  fill(p);
+}
+
+void
+eows::scidb::connection_pool::impl::run_checker()
+{
+  std::unique_lock<std::mutex> lock(checker_mtx);
+
+  while(!checker_cv.wait_for(lock, std::chrono::seconds(1), [this]() -> bool { return stop; }))
+  {
+    lock.unlock();
+
+    std::vector<pool*> due;
+
+    {
+      std::lock_guard<std::mutex> registry_lock(mtx);
+
+      const clock_type::time_point now = clock_type::now();
+
+      for(const auto& entry : pools)
+      {
+        pool* p = entry.second.get();
+
+        if((p->cluster_info.health_check_interval == 0) || (now < p->next_check))
+          continue;
+
+        p->next_check = now + std::chrono::seconds(p->cluster_info.health_check_interval);
+
+        due.push_back(p);
+      }
+    }
+
+    for(pool* p : due)
+    {
+      try
+      {
+        check(*p);
+      }
+      catch(const std::exception& e)
+      {
+        boost::format log_msg("Health check of cluster '%1%' connection pool failed: %2%");
+
+        EOWS_LOG_WARN((log_msg % p->cluster_info.id % e.what()).str());
+      }
+    }
+
+    lock.lock();
+  }
+}
+
 eows::scidb::connection
 eows::scidb::connection_pool::get(const std::string& cluster_id)
 {
-  std::lock_guard<std::mutex> lock(pimpl_->mtx);
-  
-// search cluster connection pool
-  std::list<impl::pool>::iterator it =
-      std::find_if(pimpl_->pool_list.begin(),
-                   pimpl_->pool_list.end(),
-                   [&cluster_id](const impl::pool& p) -> bool
-                   { return p.cluster_info.id == cluster_id; });
+  impl::pool* p = pimpl_->find(cluster_id);
 
 // if a connection pool for the cluster is not found,
 // throw an exception to warn this!
-  if(it == pimpl_->pool_list.end())
+  if(p == nullptr)
   {
     boost::format err_msg("Could not find a connection pool for cluster '%1%'.");
     throw std::invalid_argument((err_msg % cluster_id).str());
   }
 
-// if connection pool is found but doesn't have
-// available connections, let's try to open one more!
-  if(it->available_connections == 0)
+// the wait includes opening a new connection, when there is no idle one
+  eows::core::latency_timer timer(p->wait_duration);
+
+  std::unique_lock<std::mutex> lock(p->mtx);
+
+// wait until there is an idle connection or room for a new one
+  const auto can_acquire = [p]() -> bool
   {
-// if the pool has reached its maximum, throw an exception
-    if(it->num_connections == it->cluster_info.max_connections)
-    {
-      boost::format err_msg("Connection pool for cluster '%1%' reached its limit: %2%.");
+    return !p->idle.empty() || (p->num_connections < p->cluster_info.max_connections);
+  };
 
-      throw connection_pool_limit_error((err_msg % cluster_id % it->num_connections).str());
-    }
-    
-// ok! we can open a new connection!
-    std::unique_ptr<connection_impl> conn(new connection_impl(cluster_id));
-    
-    conn->open(it->cluster_info.coordinator_address, it->cluster_info.coordinator_port);
+  if(!p->available.wait_for(lock, std::chrono::milliseconds(p->cluster_info.acquire_timeout), can_acquire))
+  {
+    p->timeouts.inc();
+
+    boost::format err_msg("Connection pool for cluster '%1%' reached its limit: %2%. No connection was released within %3% ms.");
+
+    throw connection_pool_limit_error((err_msg % cluster_id % p->num_connections % p->cluster_info.acquire_timeout).str());
+  }
+
+// ok! there is an available connection in the pool
+  if(!p->idle.empty())
+  {
+    connection_impl* conn = p->idle.back().conn;
+
+    p->idle.pop_back();
+
+    assert(p->idle.size() <= p->num_connections);
+
+    p->in_use.inc();
+
+    return connection(conn);
+  }
+
+// reserve a slot for the new physical connection and open it outside the lock
+  ++(p->num_connections);
 
-// just to increase vector size
-    it->connections.push_back(conn.get());
+  assert(p->num_connections <= p->cluster_info.max_connections);
 
-// now we have one more physical connection
-    ++(it->num_connections);
+  lock.unlock();
 
-    assert(it->available_connections <= it->num_connections);
-    assert(it->num_connections == it->connections.size());
-    assert(it->num_connections <= it->cluster_info.max_connections);
+  try
+  {
+    std::unique_ptr<connection_impl> conn(new connection_impl(cluster_id));
+
+    conn->open(p->cluster_info.coordinator_address, p->cluster_info.coordinator_port);
+
+    p->in_use.inc();
 
     return connection(conn.release());
   }
-  else // ok! there is an available connection in the pool
+  catch(...)
   {
-    --(it->available_connections);
+// give the slot back so that a waiting request may try again
+    lock.lock();
 
-    assert(it->available_connections <= it->num_connections);
-    assert(it->num_connections == it->connections.size());
-    assert(it->num_connections <= it->cluster_info.max_connections);
+    --(p->num_connections);
 
-    return connection(it->connections[it->available_connections]);
+    lock.unlock();
+
+    p->available.notify_one();
+
+    throw;
   }
 }
 
@@ -144,24 +442,60 @@ void
 eows::scidb::connection_pool::add(const cluster_info_t& cluster_info)
 {
   std::lock_guard<std::mutex> lock(pimpl_->mtx);
-  
-// search cluster connection pool
-  std::list<impl::pool>::iterator it =
-      std::find_if(pimpl_->pool_list.begin(),
-                   pimpl_->pool_list.end(),
-                   [&cluster_info](const impl::pool& p) -> bool
-                   { return p.cluster_info.id == cluster_info.id; });
+
+  if(pimpl_->sealed.load(std::memory_order_relaxed))
+  {
+    boost::format err_msg("Could not add a connection pool for cluster '%1%': connections were already requested.");
+    throw std::logic_error((err_msg % cluster_info.id).str());
+  }
+
+  std::unique_ptr<impl::pool>& p = pimpl_->pools[cluster_info.id];
 
 // if a connection pool already exists for the cluster,
 // throw an exception to warn this!
-  if(it != pimpl_->pool_list.end())
+  if(p != nullptr)
   {
     boost::format err_msg("There is already a connection pool for cluster '%1%'.");
     throw std::invalid_argument((err_msg % cluster_info.id).str());
   }
 
 // create a new pool
-  pimpl_->pool_list.emplace_back(cluster_info);
+  p.reset(new impl::pool(cluster_info));
+}
+
+void
+eows::scidb::connection_pool::warm_up(const std::string& cluster_id)
+{
+  impl::pool* p = nullptr;
+
+// called at startup, between calls to add: don't seal the registry
+  {
+    std::lock_guard<std::mutex> lock(pimpl_->mtx);
+
+    std::map<std::string, std::unique_ptr<impl::pool> >::const_iterator it = pimpl_->pools.find(cluster_id);
+
+    if(it != pimpl_->pools.end())
+      p = it->second.get();
+  }
+
+  if(p == nullptr)
+  {
+    boost::format err_msg("Could not find a connection pool for cluster '%1%'.");
+    throw std::invalid_argument((err_msg % cluster_id).str());
+  }
+
+  pimpl_->fill(*p);
+}
+
+void
+eows::scidb::connection_pool::start_health_checker()
+{
+  std::lock_guard<std::mutex> lock(pimpl_->checker_mtx);
+
+  if(pimpl_->checker.joinable())
+    return;
+
+  pimpl_->checker = std::thread(&impl::run_checker, pimpl_);
 }
 
 eows::scidb::connection_pool&
@@ -179,33 +513,56 @@ eows::scidb::connection_pool::connection_pool()
 
 eows::scidb::connection_pool::~connection_pool()
 {
+  {
+    std::lock_guard<std::mutex> lock(pimpl_->checker_mtx);
+
+    pimpl_->stop = true;
+  }
+
+  pimpl_->checker_cv.notify_all();
+
+  if(pimpl_->checker.joinable())
+    pimpl_->checker.join();
+
   delete pimpl_;
 }
 
 void
 eows::scidb::connection_pool::release(connection_impl* conn)
 {
-  std::lock_guard<std::mutex> lock(pimpl_->mtx);
-
-  std::list<impl::pool>::iterator it =
-      std::find_if(pimpl_->pool_list.begin(),
-                   pimpl_->pool_list.end(),
-                   [conn](const impl::pool& p) -> bool
-                   { return p.cluster_info.id == conn->cluster_id(); });
+  impl::pool* p = pimpl_->find(conn->cluster_id());
   
 // if a connection pool for the cluster is not found,
 // throw an exception to warn this!
-  if(it == pimpl_->pool_list.end())
+  if(p == nullptr)
   {
     boost::format err_msg("Could not find a connection pool for cluster '%1%' in order to release a connection.");
     throw std::invalid_argument((err_msg % conn->cluster_id()).str());
   }
 
-// otherwise, return it back!
-  it->connections[it->available_connections] = conn;
-  ++(it->available_connections);
-  
-  assert(it->available_connections <= it->num_connections);
-  assert(it->num_connections <= it->cluster_info.max_connections);
-  assert(it->num_connections == it->connections.size());
+  p->in_use.dec();
+
+// otherwise, return it back, unless there are already enough idle connections
+  std::unique_ptr<connection_impl> exceeding;
+
+  {
+    std::lock_guard<std::mutex> lock(p->mtx);
+
+    if(p->idle.size() < p->cluster_info.max_idle)
+    {
+      p->idle.push_back(impl::idle_connection{conn, impl::clock_type::now()});
+    }
+    else
+    {
+      exceeding.reset(conn);
+
+      --(p->num_connections);
+    }
+
+    assert(p->idle.size() <= p->num_connections);
+    assert(p->num_connections <= p->cluster_info.max_connections);
+  }
+
+// wake up one waiting request
+  p->available.notify_one();
 }
@@ -53,19 +53,37 @@ namespace eows
       public:
       
         /*!
+          \brief Acquires a connection, waiting up to the cluster's acquire_timeout for one to be released when the pool is exhausted.
+
           \exception std::invalid_argument If a pool for the cluster doesn't exist.
           
-          \exception connection_pool_limit_error If the cluster connection pool has reached its limit.
+          \exception connection_pool_limit_error If the cluster connection pool has reached its limit and no connection was released in time.
           
           \exception open_connection_error If error occur when opening the connection.
          */
         connection get(const std::string& cluster_id);
       
         /*!
+          \brief Adds the pool of a cluster. Pools are added at startup: once a connection is requested, they are looked up without locks.
+
           \exception std::invalid_argument If a connection pool for the cluster already exists.
+
+          \exception std::logic_error If a connection was already requested.
          */
         void add(const cluster_info_t& cluster_info);
 
+        /*!
+          \brief Opens connections until the cluster pool holds its minimum number of idle connections.
+
+          \exception std::invalid_argument If a pool for the cluster doesn't exist.
+
+          \exception open_connection_error If error occur when opening a connection.
+         */
+        void warm_up(const std::string& cluster_id);
+
+        //! Starts the background thread that evicts idle connections and validates the remaining ones, reconnecting the broken ones.
+        void start_health_checker();
+
         static connection_pool& instance();
 
       protected:
@@ -42,6 +42,11 @@ namespace eows
       std::string id;
       std::string coordinator_address;
       std::size_t max_connections;
+      std::size_t acquire_timeout;   // milliseconds to wait for a free connection (0: fail fast)
+      std::size_t min_idle;          // idle connections kept open, pre-opened at startup
+      std::size_t max_idle;          // connections released above this number are closed
+      std::size_t idle_timeout;      // seconds before an idle connection above min_idle is evicted (0: never)
+      std::size_t health_check_interval; // seconds between idle connections validation (0: disabled)
       uint16_t coordinator_port;
     };
     
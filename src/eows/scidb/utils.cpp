@@ -35,6 +35,8 @@
 #include "exception.hpp"
 
 // STL
+#include <cctype>
+#include <cstring>
 #include <vector>
 
 // Boost
@@ -42,6 +44,25 @@
 #include <boost/format.hpp>
 
 
+static std::size_t read_optional_uint(const rapidjson::Value& jcluster,
+                                      const char* key,
+                                      const std::size_t default_value)
+{
+  rapidjson::Value::ConstMemberIterator jvalue = jcluster.FindMember(key);
+
+  if(jvalue == jcluster.MemberEnd())
+    return default_value;
+
+  if(!jvalue->value.IsUint())
+  {
+    boost::format err_msg("Please check key '%1%' in file '" EOWS_CONFIG_FILE "'.");
+
+    throw eows::parse_error((err_msg % key).str());
+  }
+
+  return jvalue->value.GetUint();
+}
+
 eows::scidb::cluster_info_t read(const rapidjson::Value& jcluster)
 {
   if(!jcluster.IsObject())
@@ -76,6 +97,20 @@ eows::scidb::cluster_info_t read(const rapidjson::Value& jcluster)
     throw eows::parse_error("Please check key 'max_connections' in file '" EOWS_CONFIG_FILE "'.");
 
   cluster.max_connections = jmax_connections->value.GetUint();
+
+  cluster.acquire_timeout = read_optional_uint(jcluster, "acquire_timeout", 5000);
+
+  cluster.min_idle = read_optional_uint(jcluster, "min_idle", 0);
+  cluster.max_idle = read_optional_uint(jcluster, "max_idle", cluster.max_connections);
+  cluster.idle_timeout = read_optional_uint(jcluster, "idle_timeout", 300);
+  cluster.health_check_interval = read_optional_uint(jcluster, "health_check_interval", 30);
+
+  if((cluster.min_idle > cluster.max_idle) || (cluster.max_idle > cluster.max_connections))
+  {
+    boost::format err_msg("Cluster '%1%' in file '" EOWS_CONFIG_FILE "' must satisfy: min_idle <= max_idle <= max_connections.");
+
+    throw eows::parse_error((err_msg % cluster.id).str());
+  }
         
   return cluster;
 }
@@ -122,7 +157,65 @@ void eows::scidb::initialize()
     EOWS_LOG_INFO((log_msg % cluster.id).str());
     
     connection_pool::instance().add(cluster);
+
+    try
+    {
+      connection_pool::instance().warm_up(cluster.id);
+    }
+    catch(const std::exception& e)
+    {
+      boost::format warn_msg("Could not pre-open connections to cluster '%1%': %2%");
+
+      EOWS_LOG_WARN((warn_msg % cluster.id % e.what()).str());
+    }
   }
+
+  connection_pool::instance().start_health_checker();
   
   EOWS_LOG_INFO("SciDB runtime module initialized!");
 }
+
+std::string
+eows::scidb::normalize_afl(const std::string& afl)
+{
+  std::string result;
+
+  result.reserve(afl.size());
+
+  bool in_literal = false;
+  bool pending_space = false;
+
+  for(const char c : afl)
+  {
+    if(in_literal)
+    {
+      result.push_back(c);
+
+      if(c == '\'')
+        in_literal = false;
+
+      continue;
+    }
+
+    if(std::isspace(static_cast<unsigned char>(c)))
+    {
+      pending_space = true;
+      continue;
+    }
+
+// a space is only kept between two tokens that are not punctuation, as in: "a and b"
+    const bool is_punct = (std::strchr("(),=<>+-*/", c) != nullptr);
+
+    if(pending_space && !result.empty() && !is_punct && (std::strchr("(),=<>+-*/", result.back()) == nullptr))
+      result.push_back(' ');
+
+    pending_space = false;
+
+    result.push_back(c);
+
+    if(c == '\'')
+      in_literal = true;
+  }
+
+  return result;
+}
@@ -28,6 +28,9 @@
 #ifndef __EOWS_SCIDB_UTILS_HPP__
 #define __EOWS_SCIDB_UTILS_HPP__
 
+// STL
+#include <string>
+
 namespace eows
 {
   namespace scidb
@@ -37,6 +40,14 @@ namespace eows
       \exception std::exception ...
      */
     void initialize();
+
+    /*!
+      \brief Returns a canonical form of an AFL query, so that equivalent queries can be compared.
+
+      Runs of white spaces are collapsed and spaces around punctuation are removed,
+      except inside string literals.
+     */
+    std::string normalize_afl(const std::string& afl);
   }  // end namespace scidb
 }    // end namespace eows
 
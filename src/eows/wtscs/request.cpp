@@ -195,7 +195,8 @@ string eows::wtscs::request::get_timeline(string coverage, string start_date, st
 {
   pair<std::size_t, std::size_t> time_interval;
 
-  const eows::geoarray::geoarray_t& geo_array = eows::geoarray::geoarray_manager::instance().get(coverage);
+  const std::shared_ptr<const eows::geoarray::geoarray_t> geo_array_ptr = eows::geoarray::geoarray_manager::instance().get(coverage);
+  const eows::geoarray::geoarray_t& geo_array = *geo_array_ptr;
   time_interval = geo_array.timeline.find_interval(start_date, end_date);
 
   string timeline;
@@ -0,0 +1,180 @@
+/*
+  Copyright (C) 2017 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of Earth Observation Web Services (EOWS).
+
+  EOWS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 3 as
+  published by the Free Software Foundation.
+
+  EOWS is distributed  "AS-IS" in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY OF ANY KIND; without even the implied warranty
+  of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with EOWS. See LICENSE. If not, write to
+  e-sensing team at <esensing-team@dpi.inpe.br>.
+ */
+
+
+/*!
+  \file eows/wtss/binary_encoder.cpp
+
+  \brief Encoder for the WTSS binary time series layout.
+ */
+
+// EOWS
+#include "binary_encoder.hpp"
+#include "../core/metrics.hpp"
+#include "../geoarray/data_types.hpp"
+
+// STL
+#include <cstring>
+#include <stdexcept>
+
+// Boost
+#include <boost/format.hpp>
+
+namespace
+{
+  const char magic[] = { 'W', 'T', 'S', 'B' };
+
+  const uint16_t version = 1;
+
+  template<class UInt>
+  void write_le(std::string& out, UInt v)
+  {
+    for(std::size_t i = 0; i != sizeof(UInt); ++i)
+      out.push_back(static_cast<char>((v >> (8 * i)) & 0xFF));
+  }
+
+  void write_i64(std::string& out, const int64_t v)
+  {
+    write_le(out, static_cast<uint64_t>(v));
+  }
+
+  void write_f64(std::string& out, const double v)
+  {
+    uint64_t bits = 0;
+
+    std::memcpy(&bits, &v, sizeof(double));
+
+    write_le(out, bits);
+  }
+
+  void write_str(std::string& out, const std::string& str)
+  {
+    write_le(out, static_cast<uint16_t>(str.size()));
+
+    out.append(str);
+  }
+
+  template<class T, class UInt>
+  void write_values(std::string& out, const std::vector<double>& values)
+  {
+    static_assert(sizeof(T) == sizeof(UInt), "Invalid storage type for value.");
+
+    for(const double& v : values)
+    {
+      const T tv = static_cast<T>(v);
+
+      UInt bits = 0;
+
+      std::memcpy(&bits, &tv, sizeof(T));
+
+      write_le(out, bits);
+    }
+  }
+}
+
+void
+eows::wtss::encode_binary_time_series(const std::vector<std::string>& timeline,
+                                      const double center_lon,
+                                      const double center_lat,
+                                      const int64_t col,
+                                      const int64_t row,
+                                      const std::vector<binary_time_series_t>& series,
+                                      std::string& out)
+{
+  const std::size_t base = out.size();
+
+// header
+  out.append(magic, sizeof(magic));
+  write_le(out, version);
+  write_le(out, static_cast<uint16_t>(series.size()));
+  write_le(out, static_cast<uint32_t>(timeline.size()));
+  write_f64(out, center_lon);
+  write_f64(out, center_lat);
+  write_i64(out, col);
+  write_i64(out, row);
+
+// timeline
+  for(const std::string& t : timeline)
+    write_str(out, t);
+
+// one block per attribute
+  for(const binary_time_series_t& ts : series)
+  {
+    const int dt = ts.attribute->datatype;
+
+    if(dt == eows::geoarray::datatype_t::unknown)
+    {
+      boost::format err_msg("Could not encode attribute '%1%': unknown datatype.");
+      throw std::invalid_argument((err_msg % *ts.name).str());
+    }
+
+    write_str(out, *ts.name);
+    write_str(out, eows::geoarray::datatype_t::to_string(dt));
+    write_f64(out, ts.attribute->scale_factor);
+    write_f64(out, ts.attribute->missing_value);
+    out.push_back(ts.values != nullptr ? 1 : 0);
+
+    if(ts.values == nullptr)
+      continue;
+
+    if(ts.values->size() != timeline.size())
+      throw std::invalid_argument("Could not encode time series: number of values doesn't match the timeline.");
+
+// align values to 8 bytes
+    while(((out.size() - base) % 8) != 0)
+      out.push_back(0);
+
+    switch(dt)
+    {
+      case eows::geoarray::datatype_t::int8_dt:
+        write_values<int8_t, uint8_t>(out, *ts.values);
+        break;
+      case eows::geoarray::datatype_t::uint8_dt:
+        write_values<uint8_t, uint8_t>(out, *ts.values);
+        break;
+      case eows::geoarray::datatype_t::int16_dt:
+        write_values<int16_t, uint16_t>(out, *ts.values);
+        break;
+      case eows::geoarray::datatype_t::uint16_dt:
+        write_values<uint16_t, uint16_t>(out, *ts.values);
+        break;
+      case eows::geoarray::datatype_t::int32_dt:
+        write_values<int32_t, uint32_t>(out, *ts.values);
+        break;
+      case eows::geoarray::datatype_t::uint32_dt:
+        write_values<uint32_t, uint32_t>(out, *ts.values);
+        break;
+      case eows::geoarray::datatype_t::int64_dt:
+        write_values<int64_t, uint64_t>(out, *ts.values);
+        break;
+      case eows::geoarray::datatype_t::uint64_dt:
+        write_values<uint64_t, uint64_t>(out, *ts.values);
+        break;
+      case eows::geoarray::datatype_t::float_dt:
+        write_values<float, uint32_t>(out, *ts.values);
+        break;
+      default:
+        write_values<double, uint64_t>(out, *ts.values);
+    }
+  }
+
+  static eows::core::counter& encoded_bytes = eows::core::metrics_registry::instance().get_counter("eows_encoder_bytes_total", "Bytes written by the response encoders.", {{"encoder", "wtss_binary"}});
+
+  encoded_bytes.inc(out.size() - base);
+}
@@ -0,0 +1,83 @@
+/*
+  Copyright (C) 2017 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of Earth Observation Web Services (EOWS).
+
+  EOWS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 3 as
+  published by the Free Software Foundation.
+
+  EOWS is distributed  "AS-IS" in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY OF ANY KIND; without even the implied warranty
+  of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with EOWS. See LICENSE. If not, write to
+  e-sensing team at <esensing-team@dpi.inpe.br>.
+ */
+
+
+/*!
+  \file eows/wtss/binary_encoder.hpp
+
+  \brief Encoder for the WTSS binary time series layout.
+ */
+
+#ifndef __EOWS_WTSS_BINARY_ENCODER_HPP__
+#define __EOWS_WTSS_BINARY_ENCODER_HPP__
+
+// STL
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace eows
+{
+  namespace geoarray
+  {
+    struct attribute_t;
+  }
+
+  namespace wtss
+  {
+
+    //! MIME type of the WTSS binary time series layout.
+    const char* const binary_content_type = "application/vnd.eows.wtss+octet-stream";
+
+    //! A time series to be encoded.
+    struct binary_time_series_t
+    {
+      const std::string* name;                       //!< Attribute name as queried.
+      const eows::geoarray::attribute_t* attribute;  //!< Attribute metadata: datatype, scale factor and missing value.
+      const std::vector<double>* values;             //!< The time series values or a null pointer if there is no data.
+    };
+
+    /*!
+      \brief Encode a set of time series of a location using the WTSS binary layout (see doc/wtss.md).
+
+      All fields are little-endian. Values are written with the attribute native datatype and
+      start at an offset multiple of 8 bytes, so that they can be decoded without copies.
+
+      \param timeline   The time points of the time series.
+      \param center_lon The longitude of the cell center.
+      \param center_lat The latitude of the cell center.
+      \param col        The cell column.
+      \param row        The cell row.
+      \param series     The time series, one per queried attribute.
+      \param out        The buffer where the encoded data will be appended to.
+
+      \exception std::invalid_argument If an attribute has an unknown datatype.
+     */
+    void encode_binary_time_series(const std::vector<std::string>& timeline,
+                                   const double center_lon,
+                                   const double center_lat,
+                                   const int64_t col,
+                                   const int64_t row,
+                                   const std::vector<binary_time_series_t>& series,
+                                   std::string& out);
+
+  }   // end namespace wtss
+}     // end namespace eows
+
+#endif  // __EOWS_WTSS_BINARY_ENCODER_HPP__
@@ -0,0 +1,258 @@
+/*
+  Copyright (C) 2017 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of Earth Observation Web Services (EOWS).
+
+  EOWS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 3 as
+  published by the Free Software Foundation.
+
+  EOWS is distributed  "AS-IS" in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY OF ANY KIND; without even the implied warranty
+  of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with EOWS. See LICENSE. If not, write to
+  e-sensing team at <esensing-team@dpi.inpe.br>.
+ */
+
+
+/*!
+  \file eows/wtss/region.cpp
+
+  \brief Support for region based (bbox or polygon) WTSS operations.
+ */
+
+// EOWS
+#include "region.hpp"
+
+// STL
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+// Boost
+#include <boost/algorithm/string/classification.hpp>
+#include <boost/algorithm/string/split.hpp>
+#include <boost/algorithm/string/trim.hpp>
+#include <boost/format.hpp>
+#include <boost/lexical_cast.hpp>
+
+bool
+eows::wtss::polygon_t::contains(const double& x, const double& y) const
+{
+  bool inside = false;
+
+  for(const ring_t& ring : rings)
+  {
+    const std::size_t npts = ring.size();
+
+    for(std::size_t i = 0, j = npts - 1; i < npts; j = i++)
+    {
+      const double& xi = ring[i].first;
+      const double& yi = ring[i].second;
+      const double& xj = ring[j].first;
+      const double& yj = ring[j].second;
+
+      if(((yi > y) != (yj > y)) && (x < (xj - xi) * (y - yi) / (yj - yi) + xi))
+        inside = !inside;
+    }
+  }
+
+  return inside;
+}
+
+void
+eows::wtss::polygon_t::envelope(double& xmin, double& ymin, double& xmax, double& ymax) const
+{
+  xmin = ymin = std::numeric_limits<double>::max();
+  xmax = ymax = std::numeric_limits<double>::lowest();
+
+  for(const ring_t& ring : rings)
+  {
+    for(const auto& pt : ring)
+    {
+      xmin = std::min(xmin, pt.first);
+      ymin = std::min(ymin, pt.second);
+      xmax = std::max(xmax, pt.first);
+      ymax = std::max(ymax, pt.second);
+    }
+  }
+}
+
+eows::wtss::polygon_t
+eows::wtss::parse_wkt_polygon(const std::string& wkt)
+{
+  std::string str = boost::algorithm::trim_copy(wkt);
+
+  const std::string tag("POLYGON");
+
+  if((str.size() < tag.size()) ||
+     !std::equal(tag.begin(), tag.end(), str.begin(), [](char a, char b) -> bool { return a == std::toupper(static_cast<unsigned char>(b)); }))
+    throw std::invalid_argument("Invalid WKT: only POLYGON geometries are supported.");
+
+  std::string::size_type begin = str.find('(');
+  std::string::size_type end = str.rfind(')');
+
+  if((begin == std::string::npos) || (end == std::string::npos) || (end <= begin))
+    throw std::invalid_argument("Invalid WKT polygon: missing parentheses.");
+
+// strip the outer parentheses: (x y, ...), (x y, ...)
+  str = str.substr(begin + 1, end - begin - 1);
+
+  polygon_t poly;
+
+  std::string::size_type pos = 0;
+
+  while((begin = str.find('(', pos)) != std::string::npos)
+  {
+    end = str.find(')', begin);
+
+    if(end == std::string::npos)
+      throw std::invalid_argument("Invalid WKT polygon: unbalanced parentheses.");
+
+    std::vector<std::string> str_pts;
+
+    const std::string str_ring = str.substr(begin + 1, end - begin - 1);
+
+    boost::split(str_pts, str_ring, boost::is_any_of(","));
+
+    polygon_t::ring_t ring;
+
+    for(const std::string& str_pt : str_pts)
+    {
+      std::istringstream iss(str_pt);
+
+      double x = 0.0;
+      double y = 0.0;
+
+      if(!(iss >> x >> y))
+      {
+        boost::format err_msg("Invalid WKT polygon: could not read coordinate '%1%'.");
+        throw std::invalid_argument((err_msg % str_pt).str());
+      }
+
+      ring.push_back(std::make_pair(x, y));
+    }
+
+    if(ring.size() < 4)
+      throw std::invalid_argument("Invalid WKT polygon: a ring must have at least four coordinates.");
+
+    poly.rings.push_back(ring);
+
+    pos = end + 1;
+  }
+
+  if(poly.rings.empty())
+    throw std::invalid_argument("Invalid WKT polygon: no rings found.");
+
+  return poly;
+}
+
+eows::wtss::polygon_t
+eows::wtss::parse_bbox(const std::string& bbox)
+{
+  std::vector<std::string> values;
+
+  boost::split(values, bbox, boost::is_any_of(","));
+
+  if(values.size() != 4)
+    throw std::invalid_argument("Invalid bbox: expected 'xmin,ymin,xmax,ymax'.");
+
+  const double xmin = boost::lexical_cast<double>(boost::algorithm::trim_copy(values[0]));
+  const double ymin = boost::lexical_cast<double>(boost::algorithm::trim_copy(values[1]));
+  const double xmax = boost::lexical_cast<double>(boost::algorithm::trim_copy(values[2]));
+  const double ymax = boost::lexical_cast<double>(boost::algorithm::trim_copy(values[3]));
+
+  if((xmin > xmax) || (ymin > ymax))
+  {
+    boost::format err_msg("Invalid bbox: '%1%'.");
+    throw std::invalid_argument((err_msg % bbox).str());
+  }
+
+  polygon_t poly;
+
+  poly.rings.push_back({ {xmin, ymin}, {xmax, ymin}, {xmax, ymax}, {xmin, ymax}, {xmin, ymin} });
+
+  return poly;
+}
+
+eows::wtss::time_series_statistics::time_series_statistics(const std::size_t ntime_pts,
+                                                           const bool keep_samples)
+  : count_(ntime_pts, 0),
+    mean_(ntime_pts, 0.0),
+    m2_(ntime_pts, 0.0),
+    samples_(keep_samples ? ntime_pts : 0),
+    sorted_(keep_samples ? ntime_pts : 0, false),
+    keep_samples_(keep_samples)
+{
+}
+
+void
+eows::wtss::time_series_statistics::add(const std::size_t t, const double& value)
+{
+// Welford's online algorithm for mean and variance
+  const std::size_t n = ++count_[t];
+
+  const double delta = value - mean_[t];
+
+  mean_[t] += delta / static_cast<double>(n);
+
+  m2_[t] += delta * (value - mean_[t]);
+
+  if(keep_samples_)
+  {
+    samples_[t].push_back(value);
+    sorted_[t] = false;
+  }
+}
+
+std::size_t
+eows::wtss::time_series_statistics::count(const std::size_t t) const
+{
+  return count_[t];
+}
+
+double
+eows::wtss::time_series_statistics::mean(const std::size_t t) const
+{
+  return mean_[t];
+}
+
+double
+eows::wtss::time_series_statistics::stddev(const std::size_t t) const
+{
+  if(count_[t] == 0)
+    return 0.0;
+
+  return std::sqrt(m2_[t] / static_cast<double>(count_[t]));
+}
+
+double
+eows::wtss::time_series_statistics::percentile(const std::size_t t, const double& p)
+{
+  if(!keep_samples_)
+    throw std::logic_error("Percentiles can not be computed: samples were not kept.");
+
+  std::vector<double>& samples = samples_[t];
+
+  if(samples.empty())
+    return 0.0;
+
+  if(!sorted_[t])
+  {
+    std::sort(samples.begin(), samples.end());
+    sorted_[t] = true;
+  }
+
+  const double rank = (std::min(std::max(p, 0.0), 100.0) / 100.0) * static_cast<double>(samples.size() - 1);
+
+  const std::size_t lower = static_cast<std::size_t>(std::floor(rank));
+  const std::size_t upper = static_cast<std::size_t>(std::ceil(rank));
+
+  return samples[lower] + (rank - static_cast<double>(lower)) * (samples[upper] - samples[lower]);
+}
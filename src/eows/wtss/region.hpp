@@ -0,0 +1,112 @@
+/*
+  Copyright (C) 2017 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of Earth Observation Web Services (EOWS).
+
+  EOWS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 3 as
+  published by the Free Software Foundation.
+
+  EOWS is distributed  "AS-IS" in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY OF ANY KIND; without even the implied warranty
+  of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with EOWS. See LICENSE. If not, write to
+  e-sensing team at <esensing-team@dpi.inpe.br>.
+ */
+
+
+/*!
+  \file eows/wtss/region.hpp
+
+  \brief Support for region based (bbox or polygon) WTSS operations.
+ */
+
+#ifndef __EOWS_WTSS_REGION_HPP__
+#define __EOWS_WTSS_REGION_HPP__
+
+// STL
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace eows
+{
+  namespace wtss
+  {
+
+    //! A simple polygon with an optional list of holes, in the even-odd rule sense.
+    struct polygon_t
+    {
+      typedef std::vector<std::pair<double, double> > ring_t;
+
+      std::vector<ring_t> rings;  //!< The first ring is the outer boundary, the others are holes.
+
+      //! Returns true if the point (x, y) is inside the polygon.
+      bool contains(const double& x, const double& y) const;
+
+      //! Compute the bounding box of the polygon.
+      void envelope(double& xmin, double& ymin, double& xmax, double& ymax) const;
+    };
+
+    /*!
+      \brief Creates a polygon from a WKT string in the form: POLYGON((x1 y1, x2 y2, ...), (hole1...)).
+
+      \exception std::invalid_argument If the WKT is not a valid polygon.
+     */
+    polygon_t parse_wkt_polygon(const std::string& wkt);
+
+    /*!
+      \brief Creates a polygon from a string in the form: xmin,ymin,xmax,ymax.
+
+      \exception std::invalid_argument If the bbox is not valid.
+     */
+    polygon_t parse_bbox(const std::string& bbox);
+
+    //! Accumulate the values of a region along the time in order to compute statistics per time step.
+    class time_series_statistics
+    {
+      public:
+
+        /*!
+          \param ntime_pts    The number of time steps.
+          \param keep_samples If true, the values are kept in order to compute median and percentiles.
+         */
+        time_series_statistics(const std::size_t ntime_pts, const bool keep_samples);
+
+        //! Add a new value to time step t.
+        void add(const std::size_t t, const double& value);
+
+        //! The number of values in time step t.
+        std::size_t count(const std::size_t t) const;
+
+        //! The mean of time step t.
+        double mean(const std::size_t t) const;
+
+        //! The population standard deviation of time step t.
+        double stddev(const std::size_t t) const;
+
+        /*!
+          \brief The p-th percentile (with linear interpolation) of time step t.
+
+          \exception std::logic_error If samples are not being kept.
+         */
+        double percentile(const std::size_t t, const double& p);
+
+      private:
+
+        std::vector<std::size_t> count_;
+        std::vector<double> mean_;
+        std::vector<double> m2_;
+        std::vector<std::vector<double> > samples_;
+        std::vector<bool> sorted_;
+        bool keep_samples_;
+    };
+
+  }   // end namespace wtss
+}     // end namespace eows
+
+#endif  // __EOWS_WTSS_REGION_HPP__
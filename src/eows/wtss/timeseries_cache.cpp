@@ -0,0 +1,268 @@
+/*
+  Copyright (C) 2017 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of Earth Observation Web Services (EOWS).
+
+  EOWS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 3 as
+  published by the Free Software Foundation.
+
+  EOWS is distributed  "AS-IS" in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY OF ANY KIND; without even the implied warranty
+  of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with EOWS. See LICENSE. If not, write to
+  e-sensing team at <esensing-team@dpi.inpe.br>.
+ */
+
+
+/*!
+  \file eows/wtss/timeseries_cache.cpp
+
+  \brief An in-memory cache for time series retrieved by WTSS operations.
+ */
+
+// EOWS
+#include "timeseries_cache.hpp"
+
+// STL
+#include <atomic>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace
+{
+  struct cache_entry
+  {
+    std::string key;
+    std::string coverage;
+    eows::wtss::timeseries_cache::values_ptr values;
+    std::size_t nbytes;
+  };
+
+  struct shard
+  {
+    typedef std::list<cache_entry> lru_list_t;
+
+    std::mutex mtx;
+    lru_list_t lru;   //!< Most recently used entries at front.
+    std::unordered_map<std::string, lru_list_t::iterator> idx;
+    std::size_t nbytes;
+    std::size_t max_bytes;
+
+    shard()
+      : nbytes(0), max_bytes(0)
+    {
+    }
+
+    void erase(lru_list_t::iterator it)
+    {
+      nbytes -= it->nbytes;
+      idx.erase(it->key);
+      lru.erase(it);
+    }
+  };
+
+  std::string make_key(const std::string& coverage,
+                       const int64_t col, const int64_t row,
+                       const std::string& attribute,
+                       const std::size_t t1, const std::size_t t2)
+  {
+    return coverage + '|' + std::to_string(col) + '|' + std::to_string(row) + '|'
+         + attribute + '|' + std::to_string(t1) + '|' + std::to_string(t2);
+  }
+}
+
+struct eows::wtss::timeseries_cache::impl
+{
+  std::vector<std::unique_ptr<shard> > shards;
+  std::atomic<std::size_t> generation;  //!< Changed by every invalidation
+
+  impl()
+    : generation(0)
+  {
+  }
+
+  shard& get_shard(const std::string& key)
+  {
+    return *shards[std::hash<std::string>()(key) % shards.size()];
+  }
+};
+
+void
+eows::wtss::timeseries_cache::configure(const std::size_t max_bytes, const std::size_t nshards)
+{
+  pimpl_->shards.clear();
+
+  if(max_bytes == 0)
+    return;
+
+  const std::size_t n = (nshards == 0) ? 1 : nshards;
+
+  for(std::size_t i = 0; i != n; ++i)
+  {
+    std::unique_ptr<shard> s(new shard);
+
+    s->max_bytes = max_bytes / n;
+
+    pimpl_->shards.push_back(std::move(s));
+  }
+}
+
+std::size_t
+eows::wtss::timeseries_cache::generation() const
+{
+  return pimpl_->generation.load();
+}
+
+bool
+eows::wtss::timeseries_cache::enabled() const
+{
+  return !pimpl_->shards.empty();
+}
+
+eows::wtss::timeseries_cache::values_ptr
+eows::wtss::timeseries_cache::find(const std::string& coverage,
+                                   const int64_t col, const int64_t row,
+                                   const std::string& attribute,
+                                   const std::size_t t1, const std::size_t t2)
+{
+  if(pimpl_->shards.empty())
+    return values_ptr();
+
+  const std::string key = make_key(coverage, col, row, attribute, t1, t2);
+
+  shard& s = pimpl_->get_shard(key);
+
+  std::lock_guard<std::mutex> lock(s.mtx);
+
+  auto it = s.idx.find(key);
+
+  if(it == s.idx.end())
+    return values_ptr();
+
+// move the entry to the front of the LRU list
+  s.lru.splice(s.lru.begin(), s.lru, it->second);
+
+  return it->second->values;
+}
+
+void
+eows::wtss::timeseries_cache::insert(const std::string& coverage,
+                                     const int64_t col, const int64_t row,
+                                     const std::string& attribute,
+                                     const std::size_t t1, const std::size_t t2,
+                                     values_ptr values,
+                                     const std::size_t generation)
+{
+  if(pimpl_->shards.empty() || !values)
+    return;
+
+  cache_entry entry;
+
+  entry.key = make_key(coverage, col, row, attribute, t1, t2);
+  entry.coverage = coverage;
+  entry.values = std::move(values);
+  entry.nbytes = sizeof(cache_entry) + (2 * entry.key.size()) + entry.coverage.size()
+               + (entry.values->size() * sizeof(double));
+
+  shard& s = pimpl_->get_shard(entry.key);
+
+  if(entry.nbytes > s.max_bytes)
+    return;
+
+  std::lock_guard<std::mutex> lock(s.mtx);
+
+// the cache was invalidated while the values were queried: they may be stale
+  if(generation != pimpl_->generation.load())
+    return;
+
+  auto it = s.idx.find(entry.key);
+
+  if(it != s.idx.end())
+    s.erase(it->second);
+
+// evict the least recently used entries until the new one fits
+  while(!s.lru.empty() && ((s.nbytes + entry.nbytes) > s.max_bytes))
+    s.erase(std::prev(s.lru.end()));
+
+  s.nbytes += entry.nbytes;
+
+  s.lru.push_front(std::move(entry));
+
+  s.idx[s.lru.front().key] = s.lru.begin();
+}
+
+void
+eows::wtss::timeseries_cache::invalidate(const std::string& coverage)
+{
+// changed before erasing, so that an insert checking it under a shard lock is either refused or erased here
+  ++pimpl_->generation;
+
+  for(auto& s : pimpl_->shards)
+  {
+    std::lock_guard<std::mutex> lock(s->mtx);
+
+    for(auto it = s->lru.begin(); it != s->lru.end();)
+    {
+      auto current = it++;
+
+      if(current->coverage == coverage)
+        s->erase(current);
+    }
+  }
+}
+
+void
+eows::wtss::timeseries_cache::clear()
+{
+  ++pimpl_->generation;
+
+  for(auto& s : pimpl_->shards)
+  {
+    std::lock_guard<std::mutex> lock(s->mtx);
+
+    s->lru.clear();
+    s->idx.clear();
+    s->nbytes = 0;
+  }
+}
+
+std::size_t
+eows::wtss::timeseries_cache::size() const
+{
+  std::size_t nbytes = 0;
+
+  for(auto& s : pimpl_->shards)
+  {
+    std::lock_guard<std::mutex> lock(s->mtx);
+
+    nbytes += s->nbytes;
+  }
+
+  return nbytes;
+}
+
+eows::wtss::timeseries_cache&
+eows::wtss::timeseries_cache::instance()
+{
+  static timeseries_cache inst;
+
+  return inst;
+}
+
+eows::wtss::timeseries_cache::timeseries_cache()
+  : pimpl_(nullptr)
+{
+  pimpl_ = new impl;
+}
+
+eows::wtss::timeseries_cache::~timeseries_cache()
+{
+  delete pimpl_;
+}
@@ -0,0 +1,123 @@
+/*
+  Copyright (C) 2017 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of Earth Observation Web Services (EOWS).
+
+  EOWS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 3 as
+  published by the Free Software Foundation.
+
+  EOWS is distributed  "AS-IS" in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY OF ANY KIND; without even the implied warranty
+  of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with EOWS. See LICENSE. If not, write to
+  e-sensing team at <esensing-team@dpi.inpe.br>.
+ */
+
+
+/*!
+  \file eows/wtss/timeseries_cache.hpp
+
+  \brief An in-memory cache for time series retrieved by WTSS operations.
+ */
+
+#ifndef __EOWS_WTSS_TIMESERIES_CACHE_HPP__
+#define __EOWS_WTSS_TIMESERIES_CACHE_HPP__
+
+// STL
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Boost
+#include <boost/noncopyable.hpp>
+
+namespace eows
+{
+  namespace wtss
+  {
+
+    /*!
+      \class timeseries_cache
+
+      \brief A singleton that keeps the most recently used time series in memory.
+
+      Entries are keyed by coverage, cell (col, row), attribute and time interval.
+      The cache is split in shards, each one with its own lock and a share of
+      the byte budget, so that concurrent requests seldom contend.
+      Each shard evicts its least recently used entries when its budget is exceeded.
+     */
+    class timeseries_cache : public boost::noncopyable
+    {
+      public:
+
+        typedef std::shared_ptr<const std::vector<double> > values_ptr;
+
+        /*!
+          \brief Set the byte budget and the number of shards, discarding all cached entries.
+
+          \note This method must be called before the service starts answering requests.
+         */
+        void configure(const std::size_t max_bytes, const std::size_t nshards);
+
+        //! Returns true if the cache has a non-zero budget.
+        bool enabled() const;
+
+        //! Returns the cached time series or a null pointer if it is not in the cache.
+        values_ptr find(const std::string& coverage,
+                        const int64_t col, const int64_t row,
+                        const std::string& attribute,
+                        const std::size_t t1, const std::size_t t2);
+
+        //! Returns a number changed by every invalidation. Read it before querying the values to insert.
+        std::size_t generation() const;
+
+        /*!
+          \brief Add a time series to the cache, replacing any previous entry with the same key.
+
+          \param generation The cache generation read before the values were queried. If the cache was
+                            invalidated since then, the values may be stale and are not kept.
+         */
+        void insert(const std::string& coverage,
+                    const int64_t col, const int64_t row,
+                    const std::string& attribute,
+                    const std::size_t t1, const std::size_t t2,
+                    values_ptr values,
+                    const std::size_t generation);
+
+        //! Remove all the entries of a given coverage.
+        void invalidate(const std::string& coverage);
+
+        //! Remove all entries.
+        void clear();
+
+        //! Returns the number of bytes in use by the cached entries.
+        std::size_t size() const;
+
+        //! Access the singleton.
+        static timeseries_cache& instance();
+
+      private:
+
+        //! Constructor.
+        timeseries_cache();
+
+        //! Destructor.
+        ~timeseries_cache();
+
+      private:
+
+        struct impl;
+
+        impl* pimpl_;
+    };
+
+  }   // end namespace wtss
+}     // end namespace eows
+
+#endif  // __EOWS_WTSS_TIMESERIES_CACHE_HPP__
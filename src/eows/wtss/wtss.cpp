@@ -27,10 +27,17 @@
 
 // EOWS
 #include "wtss.hpp"
+#include "binary_encoder.hpp"
+#include "region.hpp"
+#include "timeseries_cache.hpp"
+#include "../exception.hpp"
+#include "../core/app_settings.hpp"
+#include "../core/defines.hpp"
 #include "../core/logger.hpp"
 #include "../core/http_response.hpp"
 #include "../core/http_request.hpp"
 #include "../core/service_operations_manager.hpp"
+#include "../core/single_flight.hpp"
 #include "../core/utils.hpp"
 #include "../geoarray/geoarray_manager.hpp"
 #include "../geoarray/utils.hpp"
@@ -38,10 +45,17 @@
 #include "../scidb/connection_pool.hpp"
 #include "../scidb/cell_iterator.hpp"
 #include "../scidb/scoped_query.hpp"
+#include "../scidb/utils.hpp"
 #include "../proj4/converter.hpp"
 
+// STL
+#include <algorithm>
+#include <limits>
+#include <map>
+
 // Boost
 #include <boost/algorithm/string/classification.hpp>
+#include <boost/algorithm/string/join.hpp>
 #include <boost/algorithm/string/split.hpp>
 #include <boost/format.hpp>
 #include <boost/lexical_cast.hpp>
@@ -50,6 +64,7 @@
 #include <SciDBAPI.h>
 
 // RapidJSON
+#include <rapidjson/document.h>
 #include <rapidjson/rapidjson.h>
 #include <rapidjson/stringbuffer.h>
 #include <rapidjson/writer.h>
@@ -57,6 +72,44 @@
 static void
 return_exception(const char* msg, eows::core::http_response& res);
 
+//! Size of the window used to group batch locations when the array chunk size is unknown.
+static const int64_t default_batch_window = 64;
+
+//! The decoded values of a time series query: one series for each projected attribute.
+typedef std::shared_ptr<const std::vector<std::vector<double> > > query_values_ptr;
+
+//! Coalesces identical time series queries running at the same time.
+static eows::core::single_flight<std::vector<std::vector<double> > > query_flights;
+
+//! Default byte budget of the time series cache.
+static const std::size_t default_cache_max_size = 64 * 1024 * 1024;
+
+//! Default number of shards of the time series cache.
+static const std::size_t default_cache_shards = 16;
+
+//! Default maximum number of points of a time_series_batch request.
+static const std::size_t default_batch_max_points = 1000;
+
+//! Maximum number of points of a time_series_batch request, read from the configuration at startup.
+static std::size_t batch_max_points = default_batch_max_points;
+
+//! Rejects a time_series_batch request with more points than allowed.
+static void
+check_batch_size(const std::size_t npoints)
+{
+  if(npoints > batch_max_points)
+  {
+    boost::format err_msg("WTSS 'time_series_batch' operation error: the request has %1% points, the limit is %2%.");
+    throw std::invalid_argument((err_msg % npoints % batch_max_points).str());
+  }
+}
+
+//! Maximum number of cells in the window covering the region of a time_series_region request.
+static const std::size_t max_region_cells = 250000;
+
+//! Maximum number of values kept for a time_series_region request computing median or percentiles.
+static const std::size_t max_region_samples = 16 * 1024 * 1024;
+
 namespace eows
 {
   namespace wtss
@@ -74,10 +127,30 @@ namespace eows
     struct timeseries_validated_parameters
     {
       std::vector<std::size_t> attribute_positions;
-      const eows::geoarray::geoarray_t* geo_array;
+      std::shared_ptr<const eows::geoarray::geoarray_t> geo_array;  //!< Kept alive while the request runs
       std::pair<std::size_t, std::size_t> time_interval;
     };
 
+    struct timeseries_batch_request_parameters
+    {
+      std::string cv_name;
+      std::vector<std::string> queried_attributes;
+      std::vector<std::pair<double, double> > points;  //!< List of (longitude, latitude).
+      std::string start_time_point;
+      std::string end_time_point;
+    };
+
+    struct region_request_parameters
+    {
+      std::string cv_name;
+      std::vector<std::string> queried_attributes;
+      polygon_t region;                       //!< The queried region in lat/long (EPSG:4326).
+      std::vector<std::string> statistics;    //!< List of statistics: mean, median, stddev.
+      std::vector<double> percentiles;        //!< List of percentiles in the range [0, 100].
+      std::string start_time_point;
+      std::string end_time_point;
+    };
+
     struct cell_location
     {
       double x;
@@ -93,34 +166,156 @@ namespace eows
     timeseries_request_parameters
     decode_timeseries_request(const eows::core::query_string_t& qstr);
 
+    timeseries_batch_request_parameters
+    decode_timeseries_batch_request(const std::string& content);
+
+    region_request_parameters
+    decode_region_request(const eows::core::query_string_t& qstr);
+
     timeseries_validated_parameters
     valid(const timeseries_request_parameters& parameters);
 
+    timeseries_validated_parameters
+    valid(const std::string& cv_name,
+          const std::vector<std::string>& queried_attributes,
+          const std::string& start_time_point,
+          const std::string& end_time_point);
+
     cell_location
     find_location(const double& longitude,
                   const double& latitude,
                   const eows::geoarray::geoarray_t* geo_array);
 
-    void compute_time_series(const timeseries_request_parameters& parameters,
-                             const timeseries_validated_parameters& vparameters,
-                             const cell_location& cell,
-                             rapidjson::Writer<rapidjson::StringBuffer>& writer);
+    /*!
+      \brief Retrieve the time series of the queried attributes for a given cell.
+
+      \return One time series per queried attribute or a null pointer for the attributes without data.
+     */
+    std::vector<timeseries_cache::values_ptr>
+    compute_time_series(const timeseries_request_parameters& parameters,
+                        const timeseries_validated_parameters& vparameters,
+                        const cell_location& cell);
+
+    //! Write the time series as a JSON array of {"attribute", "values"} objects.
+    void write_time_series(const timeseries_request_parameters& parameters,
+                           const std::vector<timeseries_cache::values_ptr>& values,
+                           rapidjson::Writer<rapidjson::StringBuffer>& writer);
+
+    /*!
+      \brief Write the time series using the WTSS binary layout.
+
+      \exception std::invalid_argument If an attribute has an unknown datatype.
+     */
+    void write_binary_time_series(const timeseries_request_parameters& parameters,
+                                  const timeseries_validated_parameters& vparameters,
+                                  const cell_location& cell,
+                                  const std::vector<timeseries_cache::values_ptr>& values,
+                                  eows::core::http_response& res);
+
+    //! Returns true if the client asked for the binary layout through the "format" parameter or the "Accept" header.
+    bool wants_binary_format(const eows::core::http_request& req,
+                             const eows::core::query_string_t& qstr);
+
+    /*!
+      \brief Compute the time series of many locations grouping them by the chunk they belong to.
+
+      Each group of locations is answered by a single query over the bounding window of the group.
+
+      \param parameters  The decoded batch request.
+      \param vparameters The validated coverage, attributes and time interval.
+      \param cells       The list of distinct cells to be retrieved.
+      \param values      The output values: for each cell, a list of time series, one per queried attribute.
+      \param has_data    The output flag telling if a cell was found in the database.
+     */
+    void compute_time_series_batch(const timeseries_batch_request_parameters& parameters,
+                                   const timeseries_validated_parameters& vparameters,
+                                   const std::vector<cell_location>& cells,
+                                   std::vector<std::vector<std::vector<double> > >& values,
+                                   std::vector<bool>& has_data);
+
+    /*!
+      \brief Compute the statistics of the queried region for each attribute and time step.
+
+      The region is rasterised onto the array grid: a cell belongs to the region if its center is inside the polygon.
+      Missing values are not taken into account.
+
+      \param parameters  The decoded region request.
+      \param vparameters The validated coverage, attributes and time interval.
+      \param writer      The writer where the statistics will be written to.
+
+      \exception std::out_of_range If the region doesn't intersect the coverage or if it is too large.
+     */
+    void compute_region_time_series(const region_request_parameters& parameters,
+                                    const timeseries_validated_parameters& vparameters,
+                                    rapidjson::Writer<rapidjson::StringBuffer>& writer);
+
+    //! A function that reads the value of an attribute in the current cell of an iterator.
+    typedef double (*cell_value_reader_t)(const eows::scidb::cell_iterator&, const std::size_t);
+
+    //! Read the value of an attribute of type T in the current cell of the iterator as a double.
+    template<class T>
+    double read_cell_value(const eows::scidb::cell_iterator& cell_it, const std::size_t attr_pos)
+    {
+      return static_cast<double>(cell_it.get<T>(attr_pos));
+    }
+
+    /*!
+      \brief Returns the reader for the given attribute datatype, so that the type is resolved only once per query.
+
+      \exception std::runtime_error If the datatype is not supported.
+     */
+    cell_value_reader_t get_cell_value_reader(const ::scidb::TypeId& id);
+
+    /*!
+      \brief Fill the time series of attributes with the same datatype T.
+
+      \return The number of cells traversed.
+     */
+    template<class T>
+    std::size_t fill(std::vector<std::vector<double> >& values,
+                     eows::scidb::cell_iterator& cell_it,
+                     const std::vector<std::size_t>& attr_pos,
+                     int64_t time_idx,
+                     int64_t offset)
+    {
+      const std::size_t nattributes = values.size();
+
+      std::size_t npts = 0;
+
+      while(!cell_it.end())
+      {
+        ++npts;
+
+        const ::scidb::Coordinate cell_idx = cell_it.get_position()[time_idx] + offset;
+
+        for(std::size_t i = 0; i != nattributes; ++i)
+          values[i][cell_idx] = static_cast<double>(cell_it.get<T>(attr_pos[i]));
+
+        cell_it.next();
+      }
+
+      return npts;
+    }
 
     /*!
-      \brief Fill the timeseries with cell values.
+      \brief Fill the time series of several attributes with cell values in a single pass over the query result.
 
-      \param values    A pre-allocated vector with at least nvalues.
-      \param cell_it   EOWS cell iterator for SciDB query result
-      \param id        The datatype of the cell.
-      \param attr_name An attribute name of array
+      \param values      A list of pre-allocated vectors (one per queried attribute) with at least nvalues each.
+      \param nvalues     The number of expected time series values.
+      \param cell_it     EOWS cell iterator for SciDB query result.
+      \param ids         The datatype of each queried attribute.
+      \param attr_pos    The position of each queried attribute in the query result.
+      \param time_idx    The position of the temporal dimension in the cell coordinates.
+      \param offset      The offset to be applied to the time coordinate in order to find a position in values.
 
       \exception eows::outof_bounds_error If the number of values found is less than or greater than the number o expected time-series values.
     */
-    void fill_time_series(std::vector<double>& values, const std::size_t nvalues,
+    void fill_time_series(std::vector<std::vector<double> >& values,
+                          const std::size_t nvalues,
                           boost::shared_ptr<eows::scidb::cell_iterator> cell_it,
-                          const ::scidb::TypeId& id,
+                          const std::vector< ::scidb::TypeId >& ids,
+                          const std::vector<std::size_t>& attr_pos,
                           int64_t time_idx,
-                          const std::string& attr_name,
                           int64_t offset);
 
   }  // end namespace wtss
@@ -163,7 +358,8 @@ eows::wtss::describe_coverage_handler::do_get(const eows::core::http_request& re
     if(it == qstr.end())
       throw std::runtime_error("Error in operation 'describe_coverage' for WTSS: missing coverage name.");
 
-    const eows::geoarray::geoarray_t& geo_array = eows::geoarray::geoarray_manager::instance().get(it->second);
+    const std::shared_ptr<const eows::geoarray::geoarray_t> geo_array_ptr = eows::geoarray::geoarray_manager::instance().get(it->second);
+    const eows::geoarray::geoarray_t& geo_array = *geo_array_ptr;
 
     rapidjson::StringBuffer buff;
     rapidjson::Writer<rapidjson::StringBuffer> writer(buff);
@@ -201,7 +397,16 @@ eows::wtss::time_series_handler::do_get(const eows::core::http_request& req,
 
     cell_location cell = find_location(parameters.longitude,
                                        parameters.latitude,
-                                       vparameters.geo_array);
+                                       vparameters.geo_array.get());
+
+    std::vector<timeseries_cache::values_ptr> values = compute_time_series(parameters, vparameters, cell);
+
+    if(wants_binary_format(req, qstr))
+    {
+      write_binary_time_series(parameters, vparameters, cell, values, res);
+
+      return;
+    }
 
     rapidjson::StringBuffer buff;
     rapidjson::Writer<rapidjson::StringBuffer> writer(buff);
@@ -214,7 +419,7 @@ eows::wtss::time_series_handler::do_get(const eows::core::http_request& req,
 
     writer.Key("attributes", static_cast<rapidjson::SizeType>(sizeof("attributes") -1));
 
-    compute_time_series(parameters, vparameters, cell, writer);
+    write_time_series(parameters, values, writer);
 
     writer.Key("timeline", static_cast<rapidjson::SizeType>(sizeof("timeline") -1));
     eows::core::write_string_array(std::begin(vparameters.geo_array->timeline.time_points()) + vparameters.time_interval.first,
@@ -311,6 +516,272 @@ eows::wtss::time_series_handler::do_get(const eows::core::http_request& req,
   }
 }
 
+void
+eows::wtss::time_series_batch_handler::do_post(const eows::core::http_request& req,
+                                               eows::core::http_response& res)
+{
+  try
+  {
+    timeseries_batch_request_parameters parameters = decode_timeseries_batch_request(req.content());
+
+    timeseries_validated_parameters vparameters = valid(parameters.cv_name,
+                                                        parameters.queried_attributes,
+                                                        parameters.start_time_point,
+                                                        parameters.end_time_point);
+
+// find the cell of each point: points falling in the same cell share the same time series
+    const std::size_t npoints = parameters.points.size();
+
+    std::vector<cell_location> cells;
+    std::vector<std::size_t> point_cell(npoints, std::numeric_limits<std::size_t>::max());
+    std::vector<std::string> point_errors(npoints);
+    std::map<std::pair<int64_t, int64_t>, std::size_t> cell_idx;
+
+    for(std::size_t i = 0; i != npoints; ++i)
+    {
+      const double& longitude = parameters.points[i].first;
+      const double& latitude = parameters.points[i].second;
+
+      try
+      {
+        if(!vparameters.geo_array->spatial_extent.intersects(longitude, latitude))
+        {
+          boost::format err_msg("WTSS 'time_series_batch' operation error: longitude '%1%' or latitude '%2%' is out of range.");
+          throw std::out_of_range((err_msg % longitude % latitude).str());
+        }
+
+        cell_location cell = find_location(longitude, latitude, vparameters.geo_array.get());
+
+        auto r = cell_idx.insert(std::make_pair(std::make_pair(cell.col, cell.row), cells.size()));
+
+        if(r.second)
+          cells.push_back(cell);
+
+        point_cell[i] = r.first->second;
+      }
+      catch(const std::exception& e)
+      {
+        point_errors[i] = e.what();
+      }
+    }
+
+    std::vector<std::vector<std::vector<double> > > values;
+    std::vector<bool> has_data;
+
+    compute_time_series_batch(parameters, vparameters, cells, values, has_data);
+
+    rapidjson::StringBuffer buff;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buff);
+
+    writer.StartObject();
+
+    writer.Key("result", static_cast<rapidjson::SizeType>(sizeof("result") -1));
+
+    writer.StartObject();
+
+    writer.Key("timeline", static_cast<rapidjson::SizeType>(sizeof("timeline") -1));
+    eows::core::write_string_array(std::begin(vparameters.geo_array->timeline.time_points()) + vparameters.time_interval.first,
+                                   std::begin(vparameters.geo_array->timeline.time_points()) + (vparameters.time_interval.second + 1),
+                                   writer);
+
+    writer.Key("points", static_cast<rapidjson::SizeType>(sizeof("points") -1));
+
+    writer.StartArray();
+
+    for(std::size_t i = 0; i != npoints; ++i)
+    {
+      writer.StartObject();
+
+      writer.Key("longitude", static_cast<rapidjson::SizeType>(sizeof("longitude") -1));
+      writer.Double(parameters.points[i].first);
+
+      writer.Key("latitude", static_cast<rapidjson::SizeType>(sizeof("latitude") -1));
+      writer.Double(parameters.points[i].second);
+
+      if(!point_errors[i].empty())
+      {
+        writer.Key("exception", static_cast<rapidjson::SizeType>(sizeof("exception") -1));
+        writer.String(point_errors[i].c_str(), static_cast<rapidjson::SizeType>(point_errors[i].length()));
+
+        writer.EndObject();
+
+        continue;
+      }
+
+      const std::size_t c = point_cell[i];
+      const cell_location& cell = cells[c];
+
+      writer.Key("coordinates", static_cast<rapidjson::SizeType>(sizeof("coordinates") -1));
+
+      writer.StartObject();
+
+      writer.Key("longitude", static_cast<rapidjson::SizeType>(sizeof("longitude") -1));
+      writer.Double(cell.center_lon);
+
+      writer.Key("latitude", static_cast<rapidjson::SizeType>(sizeof("latitude") -1));
+      writer.Double(cell.center_lat);
+
+      writer.Key("col", static_cast<rapidjson::SizeType>(sizeof("col") -1));
+      writer.Double(cell.col);
+
+      writer.Key("row", static_cast<rapidjson::SizeType>(sizeof("row") -1));
+      writer.Double(cell.row);
+
+      writer.EndObject();  // coordinates
+
+      writer.Key("attributes", static_cast<rapidjson::SizeType>(sizeof("attributes") -1));
+
+      writer.StartArray();
+
+      for(std::size_t j = 0; j != parameters.queried_attributes.size(); ++j)
+      {
+        const auto& attr_name = parameters.queried_attributes[j];
+
+        writer.StartObject();
+
+        writer.Key("attribute", static_cast<rapidjson::SizeType>(sizeof("attribute") -1));
+        writer.String(attr_name.c_str(), static_cast<rapidjson::SizeType>(attr_name.length()));
+
+        writer.Key("values", static_cast<rapidjson::SizeType>(sizeof("values") -1));
+
+        if(has_data[c])
+          eows::core::write_numeric_array(std::begin(values[c][j]), std::end(values[c][j]), writer);
+        else
+          writer.Null();
+
+        writer.EndObject();
+      }
+
+      writer.EndArray();  // attributes
+
+      writer.EndObject();  // point
+    }
+
+    writer.EndArray();  // points
+
+    writer.EndObject();  // result
+
+    writer.Key("query", static_cast<rapidjson::SizeType>(sizeof("query") -1));
+
+    writer.StartObject();
+
+    writer.Key("coverage", static_cast<rapidjson::SizeType>(sizeof("coverage") -1));
+    writer.String(parameters.cv_name.c_str(), static_cast<rapidjson::SizeType>(parameters.cv_name.length()));
+
+    writer.Key("attributes", static_cast<rapidjson::SizeType>(sizeof("attributes") -1));
+    eows::core::write_string_array(std::begin(parameters.queried_attributes),
+                                   std::end(parameters.queried_attributes),
+                                   writer);
+
+    writer.Key("start_date", static_cast<rapidjson::SizeType>(sizeof("start_date") -1));
+    writer.String(parameters.start_time_point.c_str(), static_cast<rapidjson::SizeType>(parameters.start_time_point.length()));
+
+    writer.Key("end_date", static_cast<rapidjson::SizeType>(sizeof("end_date") -1));
+    writer.String(parameters.end_time_point.c_str(), static_cast<rapidjson::SizeType>(parameters.end_time_point.length()));
+
+    writer.EndObject();  // query
+
+    writer.EndObject();
+
+    res.set_status(eows::core::http_response::OK);
+
+    res.add_header(eows::core::http_response::CONTENT_TYPE, "application/json; charset=utf-8");
+    res.add_header(eows::core::http_response::ACCESS_CONTROL_ALLOW_ORIGIN, "*");
+
+    res.write(buff.GetString(), buff.GetSize());
+  }
+  catch(const std::exception& e)
+  {
+    return_exception(e.what(), res);
+  }
+  catch(...)
+  {
+    return_exception("Unexpected error in WTSS time_series_batch operation.", res);
+  }
+}
+
+void
+eows::wtss::time_series_region_handler::do_get(const eows::core::http_request& req,
+                                               eows::core::http_response& res)
+{
+  try
+  {
+    eows::core::query_string_t qstr(req.query_string());
+
+    region_request_parameters parameters = decode_region_request(qstr);
+
+    timeseries_validated_parameters vparameters = valid(parameters.cv_name,
+                                                        parameters.queried_attributes,
+                                                        parameters.start_time_point,
+                                                        parameters.end_time_point);
+
+    rapidjson::StringBuffer buff;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buff);
+
+    writer.StartObject();
+
+    writer.Key("result", static_cast<rapidjson::SizeType>(sizeof("result") -1));
+
+    writer.StartObject();
+
+    compute_region_time_series(parameters, vparameters, writer);
+
+    writer.Key("timeline", static_cast<rapidjson::SizeType>(sizeof("timeline") -1));
+    eows::core::write_string_array(std::begin(vparameters.geo_array->timeline.time_points()) + vparameters.time_interval.first,
+                                   std::begin(vparameters.geo_array->timeline.time_points()) + (vparameters.time_interval.second + 1),
+                                   writer);
+
+    writer.EndObject();  // result
+
+    writer.Key("query", static_cast<rapidjson::SizeType>(sizeof("query") -1));
+
+    writer.StartObject();
+
+    writer.Key("coverage", static_cast<rapidjson::SizeType>(sizeof("coverage") -1));
+    writer.String(parameters.cv_name.c_str(), static_cast<rapidjson::SizeType>(parameters.cv_name.length()));
+
+    writer.Key("attributes", static_cast<rapidjson::SizeType>(sizeof("attributes") -1));
+    eows::core::write_string_array(std::begin(parameters.queried_attributes),
+                                   std::end(parameters.queried_attributes),
+                                   writer);
+
+    writer.Key("statistics", static_cast<rapidjson::SizeType>(sizeof("statistics") -1));
+    eows::core::write_string_array(std::begin(parameters.statistics),
+                                   std::end(parameters.statistics),
+                                   writer);
+
+    writer.Key("percentiles", static_cast<rapidjson::SizeType>(sizeof("percentiles") -1));
+    eows::core::write_numeric_array(std::begin(parameters.percentiles),
+                                    std::end(parameters.percentiles),
+                                    writer);
+
+    writer.Key("start_date", static_cast<rapidjson::SizeType>(sizeof("start_date") -1));
+    writer.String(parameters.start_time_point.c_str(), static_cast<rapidjson::SizeType>(parameters.start_time_point.length()));
+
+    writer.Key("end_date", static_cast<rapidjson::SizeType>(sizeof("end_date") -1));
+    writer.String(parameters.end_time_point.c_str(), static_cast<rapidjson::SizeType>(parameters.end_time_point.length()));
+
+    writer.EndObject();  // query
+
+    writer.EndObject();
+
+    res.set_status(eows::core::http_response::OK);
+
+    res.add_header(eows::core::http_response::CONTENT_TYPE, "application/json; charset=utf-8");
+    res.add_header(eows::core::http_response::ACCESS_CONTROL_ALLOW_ORIGIN, "*");
+
+    res.write(buff.GetString(), buff.GetSize());
+  }
+  catch(const std::exception& e)
+  {
+    return_exception(e.what(), res);
+  }
+  catch(...)
+  {
+    return_exception("Unexpected error in WTSS time_series_region operation.", res);
+  }
+}
+
 void
 eows::wtss::location_handler::do_get(const eows::core::http_request& req,
                                      eows::core::http_response& res)
@@ -325,7 +796,7 @@ eows::wtss::location_handler::do_get(const eows::core::http_request& req,
 
     cell_location cell = find_location(parameters.longitude,
                                        parameters.latitude,
-                                       vparameters.geo_array);
+                                       vparameters.geo_array.get());
 
     rapidjson::StringBuffer buff;
     rapidjson::Writer<rapidjson::StringBuffer> writer(buff);
@@ -422,6 +893,12 @@ static void register_operations()
   std::unique_ptr<eows::wtss::time_series_handler> ts_h(new eows::wtss::time_series_handler);
   eows::core::service_operations_manager::instance().insert("/wtss/time_series", std::move(ts_h));
 
+  std::unique_ptr<eows::wtss::time_series_batch_handler> tsb_h(new eows::wtss::time_series_batch_handler);
+  eows::core::service_operations_manager::instance().insert("/wtss/time_series_batch", std::move(tsb_h));
+
+  std::unique_ptr<eows::wtss::time_series_region_handler> tsr_h(new eows::wtss::time_series_region_handler);
+  eows::core::service_operations_manager::instance().insert("/wtss/time_series_region", std::move(tsr_h));
+
   std::unique_ptr<eows::wtss::location_handler> l_h(new eows::wtss::location_handler);
   eows::core::service_operations_manager::instance().insert("/wtss/location", std::move(l_h));
 
@@ -430,33 +907,103 @@ static void register_operations()
 
 static void initialize_operations()
 {
+// time series cache: the default budget is used if no configuration is given
+  std::size_t max_size = default_cache_max_size;
+  std::size_t nshards = default_cache_shards;
 
-}
+  const rapidjson::Document& doc = eows::core::app_settings::instance().get();
 
-void
-eows::wtss::initialize()
-{
-  EOWS_LOG_INFO("Initializing WTSS...");
+  rapidjson::Value::ConstMemberIterator jwtss = doc.FindMember("wtss");
 
-  register_operations();
+  if(jwtss != doc.MemberEnd())
+  {
+    if(!jwtss->value.IsObject())
+      throw eows::parse_error("Key 'wtss' must be a valid JSON object in file '" EOWS_CONFIG_FILE "'.");
 
-  initialize_operations();
+    rapidjson::Value::ConstMemberIterator jcache = jwtss->value.FindMember("cache");
 
-  EOWS_LOG_INFO("WTSS initialized!");
-}
+    if(jcache != jwtss->value.MemberEnd())
+    {
+      if(!jcache->value.IsObject())
+        throw eows::parse_error("Key 'wtss.cache' must be a valid JSON object in file '" EOWS_CONFIG_FILE "'.");
 
-void
-return_exception(const char* msg, eows::core::http_response& res)
-{
-  rapidjson::StringBuffer buff;
-  rapidjson::Writer<rapidjson::StringBuffer> writer(buff);
+      rapidjson::Value::ConstMemberIterator jit = jcache->value.FindMember("max_size");
 
-  writer.StartObject();
+      if(jit != jcache->value.MemberEnd())
+      {
+        if(!jit->value.IsUint64())
+          throw eows::parse_error("Please check key 'wtss.cache.max_size' in file '" EOWS_CONFIG_FILE "'.");
 
-  writer.Key("exception", static_cast<rapidjson::SizeType>(sizeof("exception") -1));
-  writer.String(msg);
+        max_size = static_cast<std::size_t>(jit->value.GetUint64());
+      }
 
-  writer.EndObject();
+      jit = jcache->value.FindMember("shards");
+
+      if(jit != jcache->value.MemberEnd())
+      {
+        if(!jit->value.IsUint() || (jit->value.GetUint() == 0))
+          throw eows::parse_error("Please check key 'wtss.cache.shards' in file '" EOWS_CONFIG_FILE "'.");
+
+        nshards = jit->value.GetUint();
+      }
+    }
+
+    rapidjson::Value::ConstMemberIterator jbatch = jwtss->value.FindMember("batch");
+
+    if(jbatch != jwtss->value.MemberEnd())
+    {
+      if(!jbatch->value.IsObject())
+        throw eows::parse_error("Key 'wtss.batch' must be a valid JSON object in file '" EOWS_CONFIG_FILE "'.");
+
+      rapidjson::Value::ConstMemberIterator jit = jbatch->value.FindMember("max_points");
+
+      if(jit != jbatch->value.MemberEnd())
+      {
+        if(!jit->value.IsUint() || (jit->value.GetUint() == 0))
+          throw eows::parse_error("Please check key 'wtss.batch.max_points' in file '" EOWS_CONFIG_FILE "'.");
+
+        batch_max_points = jit->value.GetUint();
+      }
+    }
+  }
+
+  eows::wtss::timeseries_cache::instance().configure(max_size, nshards);
+
+// cached time series of a coverage are dropped whenever its metadata changes
+  eows::geoarray::geoarray_manager::instance().add_change_listener([](const std::string& name)
+  {
+    eows::wtss::timeseries_cache::instance().invalidate(name);
+  });
+
+  boost::format msg("WTSS time series cache: %1% bytes in %2% shards.");
+
+  EOWS_LOG_INFO((msg % max_size % nshards).str());
+}
+
+void
+eows::wtss::initialize()
+{
+  EOWS_LOG_INFO("Initializing WTSS...");
+
+  register_operations();
+
+  initialize_operations();
+
+  EOWS_LOG_INFO("WTSS initialized!");
+}
+
+void
+return_exception(const char* msg, eows::core::http_response& res)
+{
+  rapidjson::StringBuffer buff;
+  rapidjson::Writer<rapidjson::StringBuffer> writer(buff);
+
+  writer.StartObject();
+
+  writer.Key("exception", static_cast<rapidjson::SizeType>(sizeof("exception") -1));
+  writer.String(msg);
+
+  writer.EndObject();
 
   res.set_status(eows::core::http_response::OK);
 
@@ -520,22 +1067,250 @@ eows::wtss::decode_timeseries_request(const eows::core::query_string_t& qstr)
   return parameters;
 }
 
+eows::wtss::timeseries_batch_request_parameters
+eows::wtss::decode_timeseries_batch_request(const std::string& content)
+{
+  rapidjson::Document doc;
+
+  doc.Parse(content.c_str());
+
+  if(doc.HasParseError() || !doc.IsObject())
+    throw std::invalid_argument("WTSS 'time_series_batch' operation error: request body must be a valid JSON object.");
+
+  timeseries_batch_request_parameters parameters;
+
+// get coverage name
+  rapidjson::Value::ConstMemberIterator jit = doc.FindMember("coverage");
+
+  if((jit == doc.MemberEnd()) || !jit->value.IsString())
+    throw std::invalid_argument("WTSS 'time_series_batch' operation error: \"coverage\" parameter is missing.");
+
+  parameters.cv_name = jit->value.GetString();
+
+// get queried attributes: either a JSON array of strings or a comma separated list
+  jit = doc.FindMember("attributes");
+
+  if(jit == doc.MemberEnd())
+  {
+    boost::format err_msg("WTSS 'time_series_batch' operation error: \"attributes\" parameter is missing for coverage '%1%'.");
+    throw std::invalid_argument((err_msg % parameters.cv_name).str());
+  }
+
+  if(jit->value.IsString())
+  {
+    boost::split(parameters.queried_attributes, jit->value.GetString(), boost::is_any_of(","));
+  }
+  else if(jit->value.IsArray())
+  {
+    for(rapidjson::SizeType i = 0; i < jit->value.Size(); ++i)
+      parameters.queried_attributes.push_back(eows::core::read_node_as_string(jit->value[i]));
+  }
+  else
+  {
+    throw std::invalid_argument("WTSS 'time_series_batch' operation error: \"attributes\" must be a string or an array of strings.");
+  }
+
+// extract start and end times if any
+  jit = doc.FindMember("start_date");
+
+  parameters.start_time_point = ((jit != doc.MemberEnd()) && jit->value.IsString()) ? jit->value.GetString() : std::string("");
+
+  jit = doc.FindMember("end_date");
+
+  parameters.end_time_point = ((jit != doc.MemberEnd()) && jit->value.IsString()) ? jit->value.GetString() : std::string("");
+
+// extract the locations: a list of {longitude, latitude} objects or a GeoJSON MultiPoint
+  jit = doc.FindMember("points");
+
+  if((jit != doc.MemberEnd()) && jit->value.IsArray())
+  {
+    check_batch_size(jit->value.Size());
+
+    for(rapidjson::SizeType i = 0; i < jit->value.Size(); ++i)
+    {
+      const rapidjson::Value& jpt = jit->value[i];
+
+      if(!jpt.IsObject() || !jpt.HasMember("longitude") || !jpt.HasMember("latitude") ||
+         !jpt["longitude"].IsNumber() || !jpt["latitude"].IsNumber())
+        throw std::invalid_argument("WTSS 'time_series_batch' operation error: each point must have a numeric \"longitude\" and \"latitude\".");
+
+      parameters.points.push_back(std::make_pair(jpt["longitude"].GetDouble(), jpt["latitude"].GetDouble()));
+    }
+  }
+  else
+  {
+    jit = doc.FindMember("geometry");
+
+    if((jit == doc.MemberEnd()) || !jit->value.IsObject())
+      throw std::invalid_argument("WTSS 'time_series_batch' operation error: \"points\" or \"geometry\" parameter is missing.");
+
+    const rapidjson::Value& jgeom = jit->value;
+
+    if(!jgeom.HasMember("type") || !jgeom["type"].IsString() ||
+       (std::string(jgeom["type"].GetString()) != "MultiPoint") ||
+       !jgeom.HasMember("coordinates") || !jgeom["coordinates"].IsArray())
+      throw std::invalid_argument("WTSS 'time_series_batch' operation error: \"geometry\" must be a GeoJSON MultiPoint.");
+
+    const rapidjson::Value& jcoords = jgeom["coordinates"];
+
+    check_batch_size(jcoords.Size());
+
+    for(rapidjson::SizeType i = 0; i < jcoords.Size(); ++i)
+    {
+      const rapidjson::Value& jpt = jcoords[i];
+
+      if(!jpt.IsArray() || (jpt.Size() < 2))
+        throw std::invalid_argument("WTSS 'time_series_batch' operation error: invalid MultiPoint coordinate.");
+
+      const rapidjson::Value& jlon = jpt[static_cast<rapidjson::SizeType>(0)];
+      const rapidjson::Value& jlat = jpt[static_cast<rapidjson::SizeType>(1)];
+
+      if(!jlon.IsNumber() || !jlat.IsNumber())
+        throw std::invalid_argument("WTSS 'time_series_batch' operation error: invalid MultiPoint coordinate.");
+
+      parameters.points.push_back(std::make_pair(jlon.GetDouble(), jlat.GetDouble()));
+    }
+  }
+
+  if(parameters.points.empty())
+    throw std::invalid_argument("WTSS 'time_series_batch' operation error: please, inform at least one point.");
+
+// ok: finished extracting parameters
+  return parameters;
+}
+
+eows::wtss::region_request_parameters
+eows::wtss::decode_region_request(const eows::core::query_string_t& qstr)
+{
+  region_request_parameters parameters;
+
+// get coverage name
+  eows::core::query_string_t::const_iterator it = qstr.find("coverage");
+  eows::core::query_string_t::const_iterator it_end = qstr.end();
+
+  if(it == it_end)
+    throw std::invalid_argument("WTSS 'time_series_region' operation error: \"coverage\" parameter is missing.");
+
+  parameters.cv_name = it->second;
+
+// get queried attributes
+  it = qstr.find("attributes");
+
+  if(it == it_end)
+  {
+    boost::format err_msg("WTSS 'time_series_region' operation error: \"attributes\" parameter is missing for coverage '%1%'.");
+    throw std::invalid_argument((err_msg % parameters.cv_name).str());
+  }
+
+  boost::split(parameters.queried_attributes, it->second, boost::is_any_of(","));
+
+// extract the region: a bbox or a WKT polygon
+  it = qstr.find("bbox");
+
+  if(it != it_end)
+  {
+    parameters.region = parse_bbox(it->second);
+  }
+  else
+  {
+    it = qstr.find("geometry");
+
+    if(it == it_end)
+      throw std::invalid_argument("WTSS 'time_series_region' operation error: \"bbox\" or \"geometry\" parameter is missing.");
+
+    parameters.region = parse_wkt_polygon(it->second);
+  }
+
+// extract the list of statistics
+  it = qstr.find("statistics");
+
+  if(it != it_end)
+    boost::split(parameters.statistics, it->second, boost::is_any_of(","));
+  else
+    parameters.statistics = { "mean", "median", "stddev" };
+
+  for(const std::string& stat : parameters.statistics)
+  {
+    if((stat != "mean") && (stat != "median") && (stat != "stddev"))
+    {
+      boost::format err_msg("WTSS 'time_series_region' operation error: statistic '%1%' is not supported.");
+      throw std::invalid_argument((err_msg % stat).str());
+    }
+  }
+
+// extract the list of percentiles if any
+  it = qstr.find("percentiles");
+
+  if(it != it_end)
+  {
+    std::vector<std::string> str_percentiles;
+
+    boost::split(str_percentiles, it->second, boost::is_any_of(","));
+
+    for(const std::string& str_p : str_percentiles)
+    {
+      double p = boost::lexical_cast<double>(str_p);
+
+      if((p < 0.0) || (p > 100.0))
+      {
+        boost::format err_msg("WTSS 'time_series_region' operation error: percentile '%1%' is out of range [0, 100].");
+        throw std::out_of_range((err_msg % str_p).str());
+      }
+
+      parameters.percentiles.push_back(p);
+    }
+  }
+
+// extract start and end times if any
+  it = qstr.find("start_date");
+
+  parameters.start_time_point = (it != it_end) ? it->second : std::string("");
+
+  it = qstr.find("end_date");
+
+  parameters.end_time_point = (it != it_end) ? it->second : std::string("");
+
+// ok: finished extracting parameters
+  return parameters;
+}
+
 eows::wtss::timeseries_validated_parameters
 eows::wtss::valid(const timeseries_request_parameters& parameters)
+{
+  timeseries_validated_parameters vparameters = valid(parameters.cv_name,
+                                                      parameters.queried_attributes,
+                                                      parameters.start_time_point,
+                                                      parameters.end_time_point);
+
+// valid input coordinates
+  if(!vparameters.geo_array->spatial_extent.intersects(parameters.longitude, parameters.latitude))
+  {
+    boost::format err_msg("WTSS 'time_series' operation error: longitude '%1%' or latitude '%2%' is out of range.");
+    throw std::out_of_range((err_msg % parameters.longitude % parameters.latitude).str());
+  }
+
+  return vparameters;
+}
+
+eows::wtss::timeseries_validated_parameters
+eows::wtss::valid(const std::string& cv_name,
+                  const std::vector<std::string>& queried_attributes,
+                  const std::string& start_time_point,
+                  const std::string& end_time_point)
 {
   timeseries_validated_parameters vparameters;
 
 // retrieve the underlying geoarray
-  vparameters.geo_array = &(eows::geoarray::geoarray_manager::instance().get(parameters.cv_name));
+  vparameters.geo_array = eows::geoarray::geoarray_manager::instance().get(cv_name);
 
 // valid queried attributes
-  if(parameters.queried_attributes.empty())
+  if(queried_attributes.empty())
   {
     boost::format err_msg("WTSS 'time_series' operation error: please, inform at least one attribute for coverage '%1%'.");
-    throw std::invalid_argument((err_msg % parameters.cv_name).str());
+    throw std::invalid_argument((err_msg % cv_name).str());
   }
 
-  for(const std::string& attr_name : parameters.queried_attributes)
+  for(const std::string& attr_name : queried_attributes)
   {
     const std::vector<eows::geoarray::attribute_t>::const_iterator it_end = vparameters.geo_array->attributes.end();
 
@@ -546,7 +1321,7 @@ eows::wtss::valid(const timeseries_request_parameters& parameters)
     if(it == it_end)
     {
       boost::format err_msg("WTSS 'time_series' operation error: attribute '%1%' doesn't belong to coverage '%2%'.");
-      throw std::invalid_argument((err_msg % attr_name % parameters.cv_name).str());
+      throw std::invalid_argument((err_msg % attr_name % cv_name).str());
     }
 
     std::size_t pos = std::distance(vparameters.geo_array->attributes.begin(), it);
@@ -555,14 +1330,7 @@ eows::wtss::valid(const timeseries_request_parameters& parameters)
   }
 
 // find and valid queried time-interval if one is provided
-  vparameters.time_interval = vparameters.geo_array->timeline.find_interval(parameters.start_time_point, parameters.end_time_point);
-
-// valid input coordinates
-  if(!vparameters.geo_array->spatial_extent.intersects(parameters.longitude, parameters.latitude))
-  {
-    boost::format err_msg("WTSS 'time_series' operation error: longitude '%1%' or latitude '%2%' is out of range.");
-    throw std::out_of_range((err_msg % parameters.longitude % parameters.latitude).str());
-  }
+  vparameters.time_interval = vparameters.geo_array->timeline.find_interval(start_time_point, end_time_point);
 
   return vparameters;
 }
@@ -610,117 +1378,712 @@ eows::wtss::find_location(const double& longitude,
   return cell;
 }
 
-void
+std::vector<eows::wtss::timeseries_cache::values_ptr>
 eows::wtss::compute_time_series(const timeseries_request_parameters& parameters,
                                 const timeseries_validated_parameters& vparameters,
-                                const cell_location& cell,
-                                rapidjson::Writer<rapidjson::StringBuffer>& writer)
+                                const cell_location& cell)
 {
-  writer.StartArray();
-
   const std::size_t ntime_pts = vparameters.time_interval.second - vparameters.time_interval.first + 1;
 
   const std::size_t nattributes = parameters.queried_attributes.size();
 
-// get a connection from the pool in order to retrieve the time series data
-  eows::scidb::connection conn(eows::scidb::connection_pool::instance().get(vparameters.geo_array->cluster_id));
+  const std::size_t t1 = vparameters.time_interval.first;
+  const std::size_t t2 = vparameters.time_interval.second;
+
+  timeseries_cache& cache = timeseries_cache::instance();
+
+// values queried across an invalidation of the cache are not kept
+  const std::size_t generation = cache.generation();
+
+// look for the time series in the cache: only the missing ones will be retrieved from the database
+  std::vector<timeseries_cache::values_ptr> values(nattributes);
+
+  std::vector<std::string> projected_attributes;
 
-// iterate through each queried attribute
   for(std::size_t i = 0; i != nattributes; ++i)
   {
     const auto& attr_name = parameters.queried_attributes[i];
-    const std::size_t& attr_pos = vparameters.attribute_positions[i];
 
-// the query string    
-    std::string str_afl = "project( between(" + parameters.cv_name + ", "
-                        + std::to_string(cell.col) + "," + std::to_string(cell.row) + "," + std::to_string(vparameters.time_interval.first) + ","
-                        + std::to_string(cell.col) + "," + std::to_string(cell.row) + "," + std::to_string(vparameters.time_interval.second) + "), "
-                        + attr_name + ")";
+    values[i] = cache.find(parameters.cv_name, cell.col, cell.row, attr_name, t1, t2);
+
+// repeated names are projected only once
+    if(!values[i] && (std::find(projected_attributes.begin(), projected_attributes.end(), attr_name) == projected_attributes.end()))
+      projected_attributes.push_back(attr_name);
+  }
+
+  if(projected_attributes.empty())
+    return values;
+
+// all missing attributes are retrieved in a single query
+  std::string str_afl = "project( between(" + parameters.cv_name + ", "
+                      + std::to_string(cell.col) + "," + std::to_string(cell.row) + "," + std::to_string(t1) + ","
+                      + std::to_string(cell.col) + "," + std::to_string(cell.row) + "," + std::to_string(t2) + "), "
+                      + boost::algorithm::join(projected_attributes, ",") + ")";
+
+// identical concurrent queries share a single execution and its decoded values, unless the cache was invalidated in between
+  query_values_ptr qvalues = query_flights.run(eows::scidb::normalize_afl(str_afl) + "|" + std::to_string(generation), [&]() -> query_values_ptr
+  {
+// get a connection from the pool in order to retrieve the time series data
+    eows::scidb::connection conn(eows::scidb::connection_pool::instance().get(vparameters.geo_array->cluster_id));
 
     boost::shared_ptr< ::scidb::QueryResult > qresult = conn.execute(str_afl);
 
     eows::scidb::scoped_query sc(qresult, &conn);
 
+// no query result returned after querying database
     if((qresult == nullptr) || (qresult->array == nullptr))
+      return query_values_ptr();
+
+    boost::shared_ptr<eows::scidb::cell_iterator> cell_it(new eows::scidb::cell_iterator(qresult->array));
+
+    const ::scidb::ArrayDesc& array_desc = qresult->array->getArrayDesc();
+    const ::scidb::Attributes& array_attributes = array_desc.getAttributes(true);
+
+// find out where each projected attribute is in the query result and its datatype
+    std::vector<std::vector<double> > result(projected_attributes.size());
+    std::vector<std::size_t> result_positions;
+    std::vector< ::scidb::TypeId > result_types;
+
+    for(std::size_t i = 0; i != projected_attributes.size(); ++i)
     {
-      writer.StartObject();
+      const eows::geoarray::attribute_t& attr = *std::find_if(vparameters.geo_array->attributes.begin(),
+                                                              vparameters.geo_array->attributes.end(),
+                                                              [&](const eows::geoarray::attribute_t& a) -> bool { return a.name == projected_attributes[i]; });
+
+      result[i].assign(ntime_pts, attr.missing_value);
+
+      result_positions.push_back(cell_it->attribute_pos(projected_attributes[i]));
+
+      result_types.push_back(array_attributes[result_positions.back()].getType());
+    }
+
+// TODO: remover o valor constante 2 abaixo pela coluna temporal!
+    fill_time_series(result, ntime_pts, std::move(cell_it), result_types, result_positions, 2, -(vparameters.time_interval.first));
+
+    return std::make_shared<const std::vector<std::vector<double> > >(std::move(result));
+  });
 
-      writer.Key("attribute", static_cast<rapidjson::SizeType>(sizeof("attribute") -1));
-      writer.String(attr_name.c_str(), static_cast<rapidjson::SizeType>(attr_name.length()));
+// attributes not in cache have no data
+  if(!qvalues)
+    return values;
+
+  for(std::size_t i = 0; i != nattributes; ++i)
+  {
+    if(values[i])
+      continue;
+
+    const std::size_t pos = std::find(projected_attributes.begin(), projected_attributes.end(), parameters.queried_attributes[i]) - projected_attributes.begin();
+
+    values[i] = std::make_shared<const std::vector<double> >((*qvalues)[pos]);
+
+    cache.insert(parameters.cv_name, cell.col, cell.row, parameters.queried_attributes[i], t1, t2, values[i], generation);
+  }
+
+  return values;
+}
+
+void
+eows::wtss::write_time_series(const timeseries_request_parameters& parameters,
+                              const std::vector<timeseries_cache::values_ptr>& values,
+                              rapidjson::Writer<rapidjson::StringBuffer>& writer)
+{
+  writer.StartArray();
+
+  for(std::size_t i = 0; i != values.size(); ++i)
+  {
+    const auto& attr_name = parameters.queried_attributes[i];
 
-      writer.Key("values", static_cast<rapidjson::SizeType>(sizeof("values") -1));
+    writer.StartObject();
+
+    writer.Key("attribute", static_cast<rapidjson::SizeType>(sizeof("attribute") -1));
+    writer.String(attr_name.c_str(), static_cast<rapidjson::SizeType>(attr_name.length()));
+
+    writer.Key("values", static_cast<rapidjson::SizeType>(sizeof("values") -1));
+
+    if(values[i])
+      eows::core::write_numeric_array(std::begin(*values[i]), std::end(*values[i]), writer);
+    else
       writer.Null();
 
-      writer.EndObject();
+    writer.EndObject();
+  }
+
+  writer.EndArray();
+}
+
+void
+eows::wtss::write_binary_time_series(const timeseries_request_parameters& parameters,
+                                     const timeseries_validated_parameters& vparameters,
+                                     const cell_location& cell,
+                                     const std::vector<timeseries_cache::values_ptr>& values,
+                                     eows::core::http_response& res)
+{
+  const std::vector<std::string>& time_points = vparameters.geo_array->timeline.time_points();
+
+  const std::vector<std::string> timeline(std::begin(time_points) + vparameters.time_interval.first,
+                                          std::begin(time_points) + (vparameters.time_interval.second + 1));
+
+  std::vector<binary_time_series_t> series;
+
+  for(std::size_t i = 0; i != values.size(); ++i)
+  {
+    binary_time_series_t ts;
+
+    ts.name = &(parameters.queried_attributes[i]);
+    ts.attribute = &(vparameters.geo_array->attributes[vparameters.attribute_positions[i]]);
+    ts.values = values[i].get();
+
+    series.push_back(ts);
+  }
+
+  std::string out;
+
+  encode_binary_time_series(timeline, cell.center_lon, cell.center_lat, cell.col, cell.row, series, out);
+
+  res.set_status(eows::core::http_response::OK);
+
+  res.add_header(eows::core::http_response::CONTENT_TYPE, binary_content_type);
+  res.add_header(eows::core::http_response::ACCESS_CONTROL_ALLOW_ORIGIN, "*");
+
+  res.write(std::move(out));
+}
+
+bool
+eows::wtss::wants_binary_format(const eows::core::http_request& req,
+                                const eows::core::query_string_t& qstr)
+{
+  eows::core::query_string_t::const_iterator it = qstr.find("format");
+
+  if(it != qstr.end())
+  {
+    if(it->second == "binary")
+      return true;
+
+    if(it->second == "json")
+      return false;
+
+    boost::format err_msg("WTSS 'time_series' operation error: format '%1%' is not supported.");
+    throw std::invalid_argument((err_msg % it->second).str());
+  }
+
+  const std::string accept = eows::core::find_header(req, "Accept");
+
+  return accept.find(binary_content_type) != std::string::npos;
+}
+
+void
+eows::wtss::compute_time_series_batch(const timeseries_batch_request_parameters& parameters,
+                                      const timeseries_validated_parameters& vparameters,
+                                      const std::vector<cell_location>& cells,
+                                      std::vector<std::vector<std::vector<double> > >& values,
+                                      std::vector<bool>& has_data)
+{
+  const std::size_t ntime_pts = vparameters.time_interval.second - vparameters.time_interval.first + 1;
+
+  const std::size_t nattributes = parameters.queried_attributes.size();
+
+  const std::size_t ncells = cells.size();
+
+  values.assign(ncells, std::vector<std::vector<double> >(nattributes));
+  has_data.assign(ncells, false);
+
+  if(ncells == 0)
+    return;
+
+  for(std::size_t i = 0; i != ncells; ++i)
+  {
+    for(std::size_t j = 0; j != nattributes; ++j)
+      values[i][j].assign(ntime_pts, vparameters.geo_array->attributes[vparameters.attribute_positions[j]].missing_value);
+  }
+
+  const eows::geoarray::dimensions_t& dims = vparameters.geo_array->dimensions;
+
+// group cells by the chunk they belong to
+  const int64_t chunk_x = dims.x.chunk_size > 0 ? dims.x.chunk_size : default_batch_window;
+  const int64_t chunk_y = dims.y.chunk_size > 0 ? dims.y.chunk_size : default_batch_window;
 
-      continue; // no query result returned after querying database.
+  std::map<std::pair<int64_t, int64_t>, std::vector<std::size_t> > groups;
+
+  for(std::size_t i = 0; i != ncells; ++i)
+  {
+    const std::pair<int64_t, int64_t> chunk_key((cells[i].col - dims.x.min_idx) / chunk_x,
+                                                (cells[i].row - dims.y.min_idx) / chunk_y);
+
+    groups[chunk_key].push_back(i);
+  }
+
+  std::vector<std::string> projected_attributes;
+
+  for(const auto& attr_name : parameters.queried_attributes)
+  {
+    if(std::find(projected_attributes.begin(), projected_attributes.end(), attr_name) == projected_attributes.end())
+      projected_attributes.push_back(attr_name);
+  }
+
+  const std::string str_attributes = boost::algorithm::join(projected_attributes, ",");
+
+  const std::string str_t1 = std::to_string(vparameters.time_interval.first);
+  const std::string str_t2 = std::to_string(vparameters.time_interval.second);
+
+// a single connection is used for all groups
+  eows::scidb::connection conn(eows::scidb::connection_pool::instance().get(vparameters.geo_array->cluster_id));
+
+  for(const auto& group : groups)
+  {
+    const std::vector<std::size_t>& group_cells = group.second;
+
+    std::map<std::pair<int64_t, int64_t>, std::size_t> cell_idx;
+
+    int64_t min_col = std::numeric_limits<int64_t>::max();
+    int64_t max_col = std::numeric_limits<int64_t>::min();
+    int64_t min_row = std::numeric_limits<int64_t>::max();
+    int64_t max_row = std::numeric_limits<int64_t>::min();
+
+    for(std::size_t i : group_cells)
+    {
+      min_col = std::min(min_col, cells[i].col);
+      max_col = std::max(max_col, cells[i].col);
+      min_row = std::min(min_row, cells[i].row);
+      max_row = std::max(max_row, cells[i].row);
+
+      cell_idx[std::make_pair(cells[i].col, cells[i].row)] = i;
     }
 
-    boost::shared_ptr<eows::scidb::cell_iterator> cell_it(new eows::scidb::cell_iterator(qresult->array));
+    std::string str_afl = "between(" + parameters.cv_name + ", "
+                        + std::to_string(min_col) + "," + std::to_string(min_row) + "," + str_t1 + ","
+                        + std::to_string(max_col) + "," + std::to_string(max_row) + "," + str_t2 + ")";
 
-    std::vector<double> values(ntime_pts, vparameters.geo_array->attributes[attr_pos].missing_value);
+// if the bounding window is sparse, restrict the result to the queried cells
+    const std::size_t window_size = static_cast<std::size_t>((max_col - min_col + 1) * (max_row - min_row + 1));
 
-    const ::scidb::ArrayDesc& array_desc = qresult->array->getArrayDesc();
-    const ::scidb::Attributes& array_attributes = array_desc.getAttributes(true);
-    const ::scidb::AttributeDesc& attr = array_attributes.front();
+    if(window_size > group_cells.size())
+    {
+      std::string str_filter;
 
-    auto attr_type = attr.getType();
+      for(std::size_t i : group_cells)
+      {
+        if(!str_filter.empty())
+          str_filter += " or ";
 
-// TODO: remover o valor constante 2 abaixo pela coluna temporal!
-    fill_time_series(values, ntime_pts, std::move(cell_it), attr.getType(), 2, attr_name, -(vparameters.time_interval.first));
+        str_filter += "(" + dims.x.name + "=" + std::to_string(cells[i].col) + " and "
+                    + dims.y.name + "=" + std::to_string(cells[i].row) + ")";
+      }
+
+      str_afl = "filter(" + str_afl + ", " + str_filter + ")";
+    }
+
+    str_afl = "project(" + str_afl + ", " + str_attributes + ")";
+
+    boost::shared_ptr< ::scidb::QueryResult > qresult = conn.execute(str_afl);
+
+    eows::scidb::scoped_query sc(qresult, &conn);
+
+    if((qresult == nullptr) || (qresult->array == nullptr))
+      continue;
+
+    eows::scidb::cell_iterator cell_it(qresult->array);
+
+    const ::scidb::Attributes& array_attributes = qresult->array->getArrayDesc().getAttributes(true);
+
+    std::vector<std::size_t> result_positions(nattributes);
+    std::vector<cell_value_reader_t> readers(nattributes);
+
+    for(std::size_t j = 0; j != nattributes; ++j)
+    {
+      result_positions[j] = cell_it.attribute_pos(parameters.queried_attributes[j]);
+      readers[j] = get_cell_value_reader(array_attributes[result_positions[j]].getType());
+    }
+
+// cells of a same location usually come in sequence: avoid looking them up at each step
+    int64_t last_col = std::numeric_limits<int64_t>::min();
+    int64_t last_row = std::numeric_limits<int64_t>::min();
+    std::size_t c = 0;
+    bool queried = false;
+
+    while(!cell_it.end())
+    {
+      const ::scidb::Coordinates& coords = cell_it.get_position();
+
+      if((coords[0] != last_col) || (coords[1] != last_row))
+      {
+        last_col = coords[0];
+        last_row = coords[1];
+
+        auto it = cell_idx.find(std::make_pair(last_col, last_row));
+
+        queried = (it != cell_idx.end());
+
+        if(queried)
+        {
+          c = it->second;
+
+// only locations with some cell in the result have data
+          has_data[c] = true;
+        }
+      }
+
+      if(queried)
+      {
+        const std::size_t t = static_cast<std::size_t>(coords[2] - vparameters.time_interval.first);
+
+        for(std::size_t j = 0; j != nattributes; ++j)
+          values[c][j][t] = readers[j](cell_it, result_positions[j]);
+      }
+
+      cell_it.next();
+    }
+  }
+}
+
+void
+eows::wtss::compute_region_time_series(const region_request_parameters& parameters,
+                                       const timeseries_validated_parameters& vparameters,
+                                       rapidjson::Writer<rapidjson::StringBuffer>& writer)
+{
+  const eows::geoarray::geoarray_t* geo_array = vparameters.geo_array.get();
+
+  const std::size_t ntime_pts = vparameters.time_interval.second - vparameters.time_interval.first + 1;
+
+  const std::size_t nattributes = parameters.queried_attributes.size();
+
+// bring the region to the array spatial reference system
+  polygon_t region = parameters.region;
+
+  if(geo_array->i_meta.srid != 4326)
+  {
+    eows::proj4::converter converter;
+    converter.set_source_srid(4326);
+    converter.set_target_srid(geo_array->i_meta.srid);
+
+    for(auto& ring : region.rings)
+      for(auto& pt : ring)
+        converter.convert(pt.first, pt.second);
+  }
+
+  double xmin, ymin, xmax, ymax;
+
+  region.envelope(xmin, ymin, xmax, ymax);
+
+  const eows::geoarray::spatial_extent_t& extent = geo_array->i_meta.spatial_extent;
+
+  xmin = std::max(xmin, extent.xmin);
+  ymin = std::max(ymin, extent.ymin);
+  xmax = std::min(xmax, extent.xmax);
+  ymax = std::min(ymax, extent.ymax);
+
+  if((xmin > xmax) || (ymin > ymax))
+    throw std::out_of_range("WTSS 'time_series_region' operation error: the region doesn't intersect the coverage.");
+
+// find the window of cells covering the region
+  const eows::geoarray::dimensions_t& dims = geo_array->dimensions;
+
+  eows::geoarray::grid g(geo_array);
+
+  const int64_t min_col = std::max(g.col(xmin), dims.x.min_idx);
+  const int64_t max_col = std::min(g.col(xmax), dims.x.max_idx);
+  const int64_t min_row = std::max(g.row(ymax), dims.y.min_idx);
+  const int64_t max_row = std::min(g.row(ymin), dims.y.max_idx);
+
+  const std::size_t ncols = static_cast<std::size_t>(max_col - min_col + 1);
+  const std::size_t nrows = static_cast<std::size_t>(max_row - min_row + 1);
+
+  if((ncols * nrows) > max_region_cells)
+  {
+    boost::format err_msg("WTSS 'time_series_region' operation error: the region has %1% cells, the limit is %2%.");
+    throw std::out_of_range((err_msg % (ncols * nrows) % max_region_cells).str());
+  }
+
+// rasterise the region: a cell belongs to it if its center is inside the polygon
+  std::vector<bool> mask(ncols * nrows, false);
+
+  std::size_t ncells = 0;
+
+  for(std::size_t r = 0; r != nrows; ++r)
+  {
+    const double y = g.y(min_row + static_cast<int64_t>(r));
+
+    for(std::size_t c = 0; c != ncols; ++c)
+    {
+      if(region.contains(g.x(min_col + static_cast<int64_t>(c)), y))
+      {
+        mask[r * ncols + c] = true;
+        ++ncells;
+      }
+    }
+  }
+
+  if(ncells == 0)
+    throw std::out_of_range("WTSS 'time_series_region' operation error: no cell center falls inside the region.");
+
+  const bool keep_samples = !parameters.percentiles.empty() ||
+                            (std::find(parameters.statistics.begin(), parameters.statistics.end(), "median") != parameters.statistics.end());
+
+// median and percentiles keep every value of the region cells
+  if(keep_samples && ((ncells * ntime_pts * nattributes) > max_region_samples))
+  {
+    boost::format err_msg("WTSS 'time_series_region' operation error: median and percentiles need %1% values for this region and time interval, the limit is %2%.");
+    throw std::out_of_range((err_msg % (ncells * ntime_pts * nattributes) % max_region_samples).str());
+  }
+
+  std::vector<time_series_statistics> stats(nattributes, time_series_statistics(ntime_pts, keep_samples));
+
+  std::vector<double> missing_values(nattributes);
+
+  for(std::size_t j = 0; j != nattributes; ++j)
+    missing_values[j] = geo_array->attributes[vparameters.attribute_positions[j]].missing_value;
+
+// retrieve the window in a single query
+  std::vector<std::string> projected_attributes;
+
+  for(const auto& attr_name : parameters.queried_attributes)
+  {
+    if(std::find(projected_attributes.begin(), projected_attributes.end(), attr_name) == projected_attributes.end())
+      projected_attributes.push_back(attr_name);
+  }
+
+  std::string str_afl = "project( between(" + parameters.cv_name + ", "
+                      + std::to_string(min_col) + "," + std::to_string(min_row) + "," + std::to_string(vparameters.time_interval.first) + ","
+                      + std::to_string(max_col) + "," + std::to_string(max_row) + "," + std::to_string(vparameters.time_interval.second) + "), "
+                      + boost::algorithm::join(projected_attributes, ",") + ")";
+
+  eows::scidb::connection conn(eows::scidb::connection_pool::instance().get(geo_array->cluster_id));
+
+  boost::shared_ptr< ::scidb::QueryResult > qresult = conn.execute(str_afl);
+
+  eows::scidb::scoped_query sc(qresult, &conn);
+
+  if((qresult != nullptr) && (qresult->array != nullptr))
+  {
+    eows::scidb::cell_iterator cell_it(qresult->array);
+
+    const ::scidb::Attributes& array_attributes = qresult->array->getArrayDesc().getAttributes(true);
+
+    std::vector<std::size_t> result_positions(nattributes);
+    std::vector<cell_value_reader_t> readers(nattributes);
+
+    for(std::size_t j = 0; j != nattributes; ++j)
+    {
+      result_positions[j] = cell_it.attribute_pos(parameters.queried_attributes[j]);
+      readers[j] = get_cell_value_reader(array_attributes[result_positions[j]].getType());
+    }
+
+// single pass over the query result accumulating the values inside the region
+    while(!cell_it.end())
+    {
+      const ::scidb::Coordinates& coords = cell_it.get_position();
+
+      const std::size_t c = static_cast<std::size_t>(coords[0] - min_col);
+      const std::size_t r = static_cast<std::size_t>(coords[1] - min_row);
+
+      if(mask[r * ncols + c])
+      {
+        const std::size_t t = static_cast<std::size_t>(coords[2] - vparameters.time_interval.first);
+
+        for(std::size_t j = 0; j != nattributes; ++j)
+        {
+          const double v = readers[j](cell_it, result_positions[j]);
+
+          if(v != missing_values[j])
+            stats[j].add(t, v);
+        }
+      }
+
+      cell_it.next();
+    }
+  }
+
+// write the result: time steps without valid values are reported with the attribute missing value
+  writer.Key("attributes", static_cast<rapidjson::SizeType>(sizeof("attributes") -1));
+
+  writer.StartArray();
+
+  std::vector<double> values(ntime_pts);
+
+  for(std::size_t j = 0; j != nattributes; ++j)
+  {
+    const auto& attr_name = parameters.queried_attributes[j];
+
+    time_series_statistics& attr_stats = stats[j];
 
     writer.StartObject();
 
     writer.Key("attribute", static_cast<rapidjson::SizeType>(sizeof("attribute") -1));
     writer.String(attr_name.c_str(), static_cast<rapidjson::SizeType>(attr_name.length()));
 
-    writer.Key("values", static_cast<rapidjson::SizeType>(sizeof("values") -1));
+    for(std::size_t t = 0; t != ntime_pts; ++t)
+      values[t] = static_cast<double>(attr_stats.count(t));
+
+    writer.Key("count", static_cast<rapidjson::SizeType>(sizeof("count") -1));
     eows::core::write_numeric_array(std::begin(values), std::end(values), writer);
 
+    for(const std::string& stat : parameters.statistics)
+    {
+      for(std::size_t t = 0; t != ntime_pts; ++t)
+      {
+        if(attr_stats.count(t) == 0)
+          values[t] = missing_values[j];
+        else if(stat == "mean")
+          values[t] = attr_stats.mean(t);
+        else if(stat == "stddev")
+          values[t] = attr_stats.stddev(t);
+        else
+          values[t] = attr_stats.percentile(t, 50.0);
+      }
+
+      writer.Key(stat.c_str(), static_cast<rapidjson::SizeType>(stat.length()));
+      eows::core::write_numeric_array(std::begin(values), std::end(values), writer);
+    }
+
+    if(!parameters.percentiles.empty())
+    {
+      writer.Key("percentiles", static_cast<rapidjson::SizeType>(sizeof("percentiles") -1));
+
+      writer.StartArray();
+
+      for(const double& p : parameters.percentiles)
+      {
+        for(std::size_t t = 0; t != ntime_pts; ++t)
+          values[t] = (attr_stats.count(t) == 0) ? missing_values[j] : attr_stats.percentile(t, p);
+
+        writer.StartObject();
+
+        writer.Key("percentile", static_cast<rapidjson::SizeType>(sizeof("percentile") -1));
+        writer.Double(p);
+
+        writer.Key("values", static_cast<rapidjson::SizeType>(sizeof("values") -1));
+        eows::core::write_numeric_array(std::begin(values), std::end(values), writer);
+
+        writer.EndObject();
+      }
+
+      writer.EndArray();  // percentiles
+    }
+
     writer.EndObject();
   }
 
-  writer.EndArray();
+  writer.EndArray();  // attributes
+
+  writer.Key("region", static_cast<rapidjson::SizeType>(sizeof("region") -1));
+
+  writer.StartObject();
+
+  writer.Key("min_col", static_cast<rapidjson::SizeType>(sizeof("min_col") -1));
+  writer.Int64(min_col);
+
+  writer.Key("max_col", static_cast<rapidjson::SizeType>(sizeof("max_col") -1));
+  writer.Int64(max_col);
+
+  writer.Key("min_row", static_cast<rapidjson::SizeType>(sizeof("min_row") -1));
+  writer.Int64(min_row);
+
+  writer.Key("max_row", static_cast<rapidjson::SizeType>(sizeof("max_row") -1));
+  writer.Int64(max_row);
+
+  writer.Key("cells", static_cast<rapidjson::SizeType>(sizeof("cells") -1));
+  writer.Uint64(ncells);
+
+  writer.EndObject();  // region
+}
+
+eows::wtss::cell_value_reader_t
+eows::wtss::get_cell_value_reader(const ::scidb::TypeId& id)
+{
+  if(id == ::scidb::TID_INT8)
+    return &read_cell_value<int8_t>;
+  else if(id == ::scidb::TID_UINT8)
+    return &read_cell_value<uint8_t>;
+  else if(id == ::scidb::TID_INT16)
+    return &read_cell_value<int16_t>;
+  else if(id == ::scidb::TID_UINT16)
+    return &read_cell_value<uint16_t>;
+  else if(id == ::scidb::TID_INT32)
+    return &read_cell_value<int32_t>;
+  else if(id == ::scidb::TID_UINT32)
+    return &read_cell_value<uint32_t>;
+  else if(id == ::scidb::TID_INT64)
+    return &read_cell_value<int64_t>;
+  else if(id == ::scidb::TID_UINT64)
+    return &read_cell_value<uint64_t>;
+  else if(id == ::scidb::TID_FLOAT)
+    return &read_cell_value<float>;
+  else if(id == ::scidb::TID_DOUBLE)
+    return &read_cell_value<double>;
+
+  boost::format err_msg("Could not fill values vector with iterator items: data type '%1%' not supported.");
+
+  throw std::runtime_error((err_msg % id).str());
 }
 
 void
-eows::wtss::fill_time_series(std::vector<double>& values,
+eows::wtss::fill_time_series(std::vector<std::vector<double> >& values,
                              const std::size_t nvalues,
                              boost::shared_ptr<eows::scidb::cell_iterator> cell_it,
-                             const ::scidb::TypeId& id,
+                             const std::vector< ::scidb::TypeId >& ids,
+                             const std::vector<std::size_t>& attr_pos,
                              int64_t time_idx,
-                             const std::string& attr_name,
                              int64_t offset)
 {
   assert(cell_it);
+  assert(values.size() == ids.size());
+  assert(values.size() == attr_pos.size());
+
+  const std::size_t nattributes = values.size();
 
   std::size_t npts = 0;
 
-  // TODO: Should pass a functor to read data to avoid conditional checks for type?
-  while(!cell_it->end())
+// when all attributes share the same datatype, use a loop specialized for that type
+  if(!ids.empty() && std::all_of(ids.begin(), ids.end(), [&ids](const ::scidb::TypeId& id) -> bool { return id == ids.front(); }))
   {
-    ++npts;
-    const ::scidb::Coordinates& coords = cell_it->get_position();
-    const ::scidb::Coordinate cell_idx = coords[time_idx] + offset;
+    const ::scidb::TypeId& id = ids.front();
 
-    if (id == ::scidb::TID_INT8)
-      values[cell_idx] = cell_it->get_int8(attr_name);
+    if(id == ::scidb::TID_INT8)
+      npts = fill<int8_t>(values, *cell_it, attr_pos, time_idx, offset);
     else if(id == ::scidb::TID_UINT8)
-      values[cell_idx] = cell_it->get_uint8(attr_name);
+      npts = fill<uint8_t>(values, *cell_it, attr_pos, time_idx, offset);
     else if(id == ::scidb::TID_INT16)
-      values[cell_idx] = cell_it->get_int16(attr_name);
+      npts = fill<int16_t>(values, *cell_it, attr_pos, time_idx, offset);
     else if(id == ::scidb::TID_UINT16)
-      values[cell_idx] = cell_it->get_uint16(attr_name);
+      npts = fill<uint16_t>(values, *cell_it, attr_pos, time_idx, offset);
     else if(id == ::scidb::TID_INT32)
-      values[cell_idx] = cell_it->get_int32(attr_name);
-    else if(id == ::scidb::TID_INT32)
-      values[cell_idx] = cell_it->get_int32(attr_name);
+      npts = fill<int32_t>(values, *cell_it, attr_pos, time_idx, offset);
+    else if(id == ::scidb::TID_UINT32)
+      npts = fill<uint32_t>(values, *cell_it, attr_pos, time_idx, offset);
+    else if(id == ::scidb::TID_INT64)
+      npts = fill<int64_t>(values, *cell_it, attr_pos, time_idx, offset);
+    else if(id == ::scidb::TID_UINT64)
+      npts = fill<uint64_t>(values, *cell_it, attr_pos, time_idx, offset);
+    else if(id == ::scidb::TID_FLOAT)
+      npts = fill<float>(values, *cell_it, attr_pos, time_idx, offset);
+    else if(id == ::scidb::TID_DOUBLE)
+      npts = fill<double>(values, *cell_it, attr_pos, time_idx, offset);
     else
-      throw std::runtime_error("Could not fill values vector with iterator items: data type not supported.");
+    {
+      boost::format err_msg("Could not fill values vector with iterator items: data type '%1%' not supported.");
+      throw std::runtime_error((err_msg % id).str());
+    }
+  }
+  else
+  {
+// attributes with mixed datatypes: resolve a reader for each one before traversing the cells
+    std::vector<cell_value_reader_t> readers;
 
-    cell_it->next();
+    for(const ::scidb::TypeId& id : ids)
+      readers.push_back(get_cell_value_reader(id));
+
+    while(!cell_it->end())
+    {
+      ++npts;
+
+      const ::scidb::Coordinate cell_idx = cell_it->get_position()[time_idx] + offset;
+
+      for(std::size_t i = 0; i != nattributes; ++i)
+        values[i][cell_idx] = readers[i](*cell_it, attr_pos[i]);
+
+      cell_it->next();
+    }
   }
 
-  if(npts != nvalues) \
+  if(npts != nvalues)
     throw std::out_of_range("Invalid timeseries range: missing some values.");
 }
@@ -69,6 +69,40 @@ namespace eows
                   eows::core::http_response& res);
     };
 
+    //! Retrieve the time series of many locations of a given coverage in a single request.
+    /*!
+      The locations are informed in the request body as a JSON document:
+      http://localhost:7654/wtss/time_series_batch
+      {
+        "coverage": "mod13q1", "attributes": ["red", "nir"],
+        "start_date": "2001-01-01", "end_date": "2001-12-31",
+        "points": [ { "longitude": -54.0, "latitude": -12.0 }, { "longitude": -54.1, "latitude": -12.1 } ]
+      }
+
+      Instead of "points", a GeoJSON MultiPoint may be informed in a "geometry" key.
+     */
+    class time_series_batch_handler : public eows::core::web_service_handler
+    {
+      using eows::core::web_service_handler::web_service_handler;
+
+      void do_post(const eows::core::http_request& req,
+                   eows::core::http_response& res);
+    };
+
+    //! Retrieve the statistics of a region of a given coverage along the time.
+    /*!
+      The region is informed either as a bbox (xmin,ymin,xmax,ymax) or as a WKT polygon, in lat/long:
+      http://localhost:7654/wtss/time_series_region?coverage=mod13q1&attributes=red,nir&bbox=-54.1,-12.1,-54.0,-12.0
+      http://localhost:7654/wtss/time_series_region?coverage=mod13q1&attributes=red&geometry=POLYGON((-54.1 -12.1,-54.0 -12.1,-54.0 -12.0,-54.1 -12.1))&statistics=mean,stddev&percentiles=10,90
+     */
+    class time_series_region_handler : public eows::core::web_service_handler
+    {
+      using eows::core::web_service_handler::web_service_handler;
+
+      void do_get(const eows::core::http_request& req,
+                  eows::core::http_response& res);
+    };
+
     //! Returns the computed locations for a given latitude/longitude.
     /*!
       Use the same parameters as in time_series operation: